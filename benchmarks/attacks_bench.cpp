@@ -0,0 +1,101 @@
+// attacks_bench.cpp
+// slider attack lookup throughput for each available backend (magic, pext)
+// and perft nps with the backend this binary was compiled with
+// attacks_bench_magic is the same benchmark compiled with MPCHESS_NO_PEXT
+//
+// usage: attacks_bench [perft depth]
+
+#include "defs.hpp"    // types, constants
+#include "utils.hpp"   // current_time
+#include "attacks.hpp" // slider attacks lookup
+#include "board.hpp"   // board
+#include "perft.hpp"   // perft
+#include "rng.hpp"     // xorshift64
+
+#include <array>       // array
+#include <vector>      // vector
+#include <string>      // string
+#include <chrono>      // steady_clock
+#include <iostream>    // cout
+#include <iomanip>     // setw, setprecision
+
+using namespace MPChess;
+using namespace MPChess::Types;
+
+
+inline constexpr std::size_t NUM_LOOKUPS    = 1 << 16;
+inline constexpr std::size_t NUM_ITERATIONS = 200;
+
+// FENs from: https://www.chessprogramming.org/Perft_Results
+inline constexpr std::array<const char*, 2> PERFT_FENS = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+};
+
+constexpr const char* backend_name(Attacks::SliderBackend backend) {
+    return (backend == Attacks::SliderBackend::PEXT) ? "pext" : "magic";
+}
+
+
+// bishop + rook lookups over random squares/occupancies
+// each lookup feeds the next occupancy, so lookups can not overlap (latency bound)
+template<Attacks::SliderBackend backend>
+void bench_lookups(const std::vector<Square>& squares, const std::vector<Bitboard>& occupancies) {
+
+    Bitboard checksum = Constants::EMPTY;
+
+    const auto start_time = std::chrono::steady_clock::now();
+    for (std::size_t iter = 0; iter < NUM_ITERATIONS; ++iter) {
+        for (std::size_t ind = 0; ind < NUM_LOOKUPS; ++ind) {
+            const Bitboard occupancy = occupancies[ind] ^ (checksum & 1);
+            checksum += Attacks::slider_attacks_lookup<PieceType::BISHOP, backend>(squares[ind], occupancy)
+                      ^ Attacks::slider_attacks_lookup<PieceType::ROOK,   backend>(squares[ind], occupancy);
+        }
+    }
+    const std::chrono::duration<double, std::nano> time_spent = std::chrono::steady_clock::now() - start_time;
+
+    const double num_lookups = 2.0 * NUM_ITERATIONS * NUM_LOOKUPS;
+    std::cout << std::setw(6) << std::left << backend_name(backend)
+              << " lookups "   << static_cast<uint64_t>(num_lookups)
+              << " ns/lookup " << std::fixed << std::setprecision(3) << time_spent.count() / num_lookups
+              << " Mlookups/s " << std::setprecision(1) << 1000.0 * num_lookups / time_spent.count()
+              << " (checksum " << checksum << ")\n";
+}
+
+auto main(int argc, char* argv[]) -> int {
+
+    const unsigned int depth = (argc > 1) ? std::stoul(argv[1]) : 5;
+
+    // random lookups (same seed for every backend)
+    Rng::XorShift64 rng;
+    std::vector<Square>   squares(NUM_LOOKUPS);
+    std::vector<Bitboard> occupancies(NUM_LOOKUPS);
+    for (std::size_t ind = 0; ind < NUM_LOOKUPS; ++ind) {
+        squares[ind]     = static_cast<Square>(rng.generate() % Constants::NUM_SQUARES);
+        occupancies[ind] = rng.generate() & rng.generate();
+    }
+
+    std::cout << "compiled backend " << backend_name(Attacks::DEFAULT_SLIDER_BACKEND) << "\n\n";
+
+    bench_lookups<Attacks::SliderBackend::MAGIC>(squares, occupancies);
+#ifdef MPCHESS_USE_PEXT
+    bench_lookups<Attacks::SliderBackend::PEXT>(squares, occupancies);
+#endif
+
+    // perft with the compiled backend
+    uint64_t total_nodes = 0;
+    const auto start_time = current_time();
+    for (const char* fen : PERFT_FENS) {
+        Board board{std::string(fen)};
+        total_nodes += perft(depth, board);
+    }
+    const auto time_spent = (current_time() - start_time).count();
+
+    std::cout << "\n"
+              << "perft depth " << depth       << "\n"
+              << "nodes       " << total_nodes << "\n"
+              << "time        " << time_spent  << " ms\n"
+              << "nps         " << ((time_spent > 0) ? 1000 * total_nodes / time_spent : 0) << "\n";
+
+    return 0;
+}
\ No newline at end of file
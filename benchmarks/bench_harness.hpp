@@ -0,0 +1,151 @@
+// bench_harness.hpp
+// self-contained micro benchmark harness
+//
+// a benchmark body runs a fixed number of operations and returns a checksum (so the work can not be optimized away)
+// the body is run for a few warm-up repetitions, which also size a repetition (body calls) to at least MIN_REP_TIME,
+// then timed over many repetitions, and the median and MAD (median absolute deviation)
+// of the per-op time/cycles over repetitions are reported
+// cycles are time stamp counter cycles (constant rate, not core clock), 0 where rdtsc is not available
+
+#pragma once
+
+#include <cstdint>     // fixed width types
+#include <vector>      // vector
+#include <string>      // string
+#include <chrono>      // steady_clock
+#include <algorithm>   // sort
+#include <cmath>       // abs
+#include <ostream>     // ostream
+#include <iomanip>     // setprecision
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // rdtsc
+#endif
+
+
+namespace MPChess {
+
+namespace Bench {
+
+inline constexpr std::size_t DEFAULT_WARMUP_REPS = 3;
+inline constexpr std::size_t DEFAULT_REPS        = 25;
+
+inline constexpr std::chrono::nanoseconds MIN_REP_TIME = std::chrono::milliseconds{1};
+
+struct BenchResult {
+    std::string name;
+    std::size_t ops_per_rep; // ops per body call * body calls per rep
+    std::size_t reps;
+    double      median_ns;
+    double      mad_ns;
+    double      median_cycles;
+    double      mad_cycles;
+    uint64_t    checksum;    // of one body call
+};
+
+// checksums of every benchmark are written here, so no body is dead code
+inline volatile uint64_t checksum_sink = 0;
+
+inline uint64_t read_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// median and median absolute deviation (sorts samples)
+inline std::pair<double, double> median_mad(std::vector<double>& samples) {
+
+    auto median = [](std::vector<double>& values) {
+        std::sort(values.begin(), values.end());
+        const std::size_t mid = values.size() / 2;
+        return (values.size() % 2) ? values[mid] : (values[mid - 1] + values[mid]) / 2;
+    };
+
+    const double sample_median = median(samples);
+
+    std::vector<double> deviations;
+    deviations.reserve(samples.size());
+    for (const double sample : samples) {
+        deviations.push_back(std::abs(sample - sample_median));
+    }
+
+    return {sample_median, median(deviations)};
+}
+
+// body() runs ops_per_call operations and returns a checksum
+template<typename F>
+BenchResult run_benchmark(std::string name, std::size_t ops_per_call, F&& body,
+                          std::size_t warmup_reps = DEFAULT_WARMUP_REPS, std::size_t reps = DEFAULT_REPS) {
+
+    // reported checksum is of the first call (deterministic), all calls are summed into checksum_sink
+    uint64_t checksum  = 0;
+    uint64_t sum_calls = 0;
+
+    // warm-up, calls per rep from the fastest warm-up call
+    std::chrono::steady_clock::duration call_time = std::chrono::steady_clock::duration::max();
+    for (std::size_t rep = 0; rep < std::max<std::size_t>(warmup_reps, 1); ++rep) {
+        const auto     start_time    = std::chrono::steady_clock::now();
+        const uint64_t call_checksum = body();
+        call_time = std::min(call_time, std::chrono::steady_clock::now() - start_time);
+
+        if (rep == 0) {checksum = call_checksum;}
+        sum_calls += call_checksum;
+    }
+
+    const std::size_t calls_per_rep = std::max<std::size_t>(MIN_REP_TIME / std::max(call_time, std::chrono::steady_clock::duration{1}), 1);
+    const std::size_t ops_per_rep   = ops_per_call * calls_per_rep;
+
+    std::vector<double> ns_per_op;
+    std::vector<double> cycles_per_op;
+    ns_per_op.reserve(reps);
+    cycles_per_op.reserve(reps);
+
+    for (std::size_t rep = 0; rep < reps; ++rep) {
+        const auto     start_time   = std::chrono::steady_clock::now();
+        const uint64_t start_cycles = read_cycles();
+
+        for (std::size_t call = 0; call < calls_per_rep; ++call) {
+            sum_calls += body();
+        }
+
+        const uint64_t end_cycles = read_cycles();
+        const std::chrono::duration<double, std::nano> time_spent = std::chrono::steady_clock::now() - start_time;
+
+        ns_per_op.push_back(time_spent.count() / ops_per_rep);
+        cycles_per_op.push_back(static_cast<double>(end_cycles - start_cycles) / ops_per_rep);
+    }
+
+    checksum_sink = checksum_sink + sum_calls;
+
+    const auto [median_ns,     mad_ns]     = median_mad(ns_per_op);
+    const auto [median_cycles, mad_cycles] = median_mad(cycles_per_op);
+
+    return {std::move(name), ops_per_rep, reps, median_ns, mad_ns, median_cycles, mad_cycles, checksum};
+}
+
+// results as a json array of objects
+inline void print_json(std::ostream& os, const std::vector<BenchResult>& results) {
+
+    os << std::fixed << std::setprecision(3) << "[\n";
+    for (std::size_t index = 0; index < results.size(); ++index) {
+        const BenchResult& result = results[index];
+
+        os << "  {"
+           << "\"name\": \""        << result.name          << "\", "
+           << "\"ops_per_rep\": "   << result.ops_per_rep   << ", "
+           << "\"reps\": "          << result.reps          << ", "
+           << "\"ns_per_op\": "     << result.median_ns     << ", "
+           << "\"ns_mad\": "        << result.mad_ns        << ", "
+           << "\"cycles_per_op\": " << result.median_cycles << ", "
+           << "\"cycles_mad\": "    << result.mad_cycles    << ", "
+           << "\"checksum\": "      << result.checksum
+           << "}" << ((index + 1 < results.size()) ? ",\n" : "\n");
+    }
+    os << "]\n";
+}
+
+} // Bench namespace
+
+} // MPChess namespace
\ No newline at end of file
@@ -0,0 +1,282 @@
+// micro_bench.cpp
+// micro benchmarks of the hot engine primitives over the bench positions
+// (movegen, make/unmake, board copy, repetition detection, uci move parsing, evaluate, slider attacks, tt probe/store,
+//  move picker construction)
+// results are printed as json (see bench_harness.hpp), so they can be tracked per commit
+//
+// usage: micro_bench [reps]
+
+#include "bench_harness.hpp" // run_benchmark, print_json
+
+#include "defs.hpp"          // types, constants
+#include "board.hpp"         // board
+#include "movegen.hpp"       // movegen
+#include "movepicker.hpp"    // movepicker
+#include "evaluation.hpp"    // evaluate
+#include "attacks.hpp"       // attacks
+#include "history.hpp"       // heuristic tables
+#include "tt.hpp"            // transposition table
+#include "bench.hpp"         // bench positions
+#include "rng.hpp"           // xorshift64
+#include "uci.hpp"           // uci notation
+
+#include <array>             // array
+#include <vector>            // vector
+#include <memory>            // unique pointer
+#include <string>            // string
+#include <iostream>          // cout
+
+using namespace MPChess;
+using namespace MPChess::Types;
+
+
+inline constexpr std::size_t NUM_RANDOM_OPS = 1 << 12;
+inline constexpr std::size_t LINE_LENGTH    = 32;
+inline constexpr std::size_t SHUFFLE_LENGTH = 96;
+
+// endgames where the pieces can shuffle for long (repetition detection scans every reversible ply)
+inline constexpr std::array<const char*, 6> SHUFFLE_FENS = {
+    "8/R7/2q5/8/6k1/8/1P5p/K6R w - - 0 1",
+    "5k2/7R/4P2p/5K2/p1r2P1p/8/8/8 b - - 0 1",
+    "8/8/1P6/5pr1/8/4R3/7k/2K5 w - - 0 1",
+    "8/3k4/8/8/8/4B3/4KB2/2B5 w - - 0 1",
+    "4k3/3q1r2/1N2r1b1/3ppN2/2nPP3/1B1R2n1/2R1Q3/3K4 w - - 0 1",
+    "8/8/8/5N2/8/p7/8/2NK3k w - - 0 1",
+};
+
+auto main(int argc, char* argv[]) -> int {
+
+    const std::size_t reps = (argc > 1) ? std::stoul(argv[1]) : Bench::DEFAULT_REPS;
+
+    // positions (and their legal moves)
+    std::vector<std::unique_ptr<Board>> boards;
+    std::vector<RegularMoveList>        legal_moves;
+    std::size_t                         num_legal_moves = 0;
+    for (const char* fen : Constants::BENCH_FENS) {
+        boards.push_back(std::make_unique<Board>(std::string(fen)));
+
+        legal_moves.emplace_back();
+        generate_moves<MoveGenType::LEGAL>(*boards.back(), legal_moves.back());
+        num_legal_moves += legal_moves.back().get_size();
+    }
+
+    // random squares/occupancies/keys
+    Rng::XorShift64 rng;
+
+    // random lines of legal moves (up to LINE_LENGTH plies deep)
+    std::vector<std::vector<Move>> lines(boards.size());
+    std::size_t                    num_line_moves = 0;
+    for (std::size_t ind = 0; ind < boards.size(); ++ind) {
+        while (lines[ind].size() < LINE_LENGTH) {
+            RegularMoveList move_list;
+            generate_moves<MoveGenType::LEGAL>(*boards[ind], move_list);
+            if (move_list.get_size() == 0) {break;}
+
+            lines[ind].push_back(move_list[rng.generate() % move_list.get_size()]);
+            boards[ind]->make_move(lines[ind].back());
+        }
+        for (std::size_t ply = 0; ply < lines[ind].size(); ++ply) {
+            boards[ind]->unmake_move();
+        }
+        num_line_moves += lines[ind].size();
+    }
+
+    // positions after random lines of reversible moves (up to SHUFFLE_LENGTH plies)
+    std::vector<std::unique_ptr<Board>> shuffle_boards;
+    for (const char* fen : SHUFFLE_FENS) {
+        shuffle_boards.push_back(std::make_unique<Board>(std::string(fen)));
+        Board& board = *shuffle_boards.back();
+
+        for (std::size_t ply = 0; ply < SHUFFLE_LENGTH; ++ply) {
+            RegularMoveList move_list;
+            generate_moves<MoveGenType::LEGAL>(board, move_list);
+
+            std::vector<Move> reversible_moves;
+            for (const Move& move : move_list) {
+                if (!move.is_capture() && piece_type(board.get_square_piece(move.get_from_square())) != PieceType::PAWN) {
+                    reversible_moves.push_back(move);
+                }
+            }
+            if (reversible_moves.empty()) {break;}
+
+            board.make_move(reversible_moves[rng.generate() % reversible_moves.size()]);
+        }
+    }
+
+    std::vector<Square>   squares(NUM_RANDOM_OPS);
+    std::vector<Bitboard> occupancies(NUM_RANDOM_OPS);
+    std::vector<Key>      keys(NUM_RANDOM_OPS);
+    for (std::size_t ind = 0; ind < NUM_RANDOM_OPS; ++ind) {
+        squares[ind]     = static_cast<Square>(rng.generate() % Constants::NUM_SQUARES);
+        occupancies[ind] = rng.generate() & rng.generate();
+        keys[ind]        = rng.generate();
+    }
+
+    TranspositionTable tt(Constants::DEFAULT_TABLE_SIZE_MB);
+    for (std::size_t ind = 0; ind < NUM_RANDOM_OPS; ind += 2) {
+        tt.store(keys[ind], Move{}, Eval{0}, Depth{1}, NodeType::PV_NODE);
+    }
+
+    auto p_heuristics = std::make_unique<HeuristicTables>();
+    p_heuristics->reset();
+    const KillerMoves killers{};
+
+    std::vector<Bench::BenchResult> results;
+
+    results.push_back(Bench::run_benchmark("movegen_pseudolegal", boards.size(), [&]{
+        uint64_t checksum = 0;
+        for (const auto& p_board : boards) {
+            RegularMoveList move_list;
+            generate_moves<MoveGenType::PSEUDOLEGAL>(*p_board, move_list);
+            checksum += move_list.get_size();
+        }
+        return checksum;
+    }, Bench::DEFAULT_WARMUP_REPS, reps));
+
+    results.push_back(Bench::run_benchmark("movegen_legal", boards.size(), [&]{
+        uint64_t checksum = 0;
+        for (const auto& p_board : boards) {
+            RegularMoveList move_list;
+            generate_moves<MoveGenType::LEGAL>(*p_board, move_list);
+            checksum += move_list.get_size();
+        }
+        return checksum;
+    }, Bench::DEFAULT_WARMUP_REPS, reps));
+
+    results.push_back(Bench::run_benchmark("make_unmake", num_legal_moves, [&]{
+        uint64_t checksum = 0;
+        for (std::size_t ind = 0; ind < boards.size(); ++ind) {
+            for (const Move& move : legal_moves[ind]) {
+                boards[ind]->make_move(move);
+                checksum += boards[ind]->get_zobrist_key();
+                boards[ind]->unmake_move();
+            }
+        }
+        return checksum;
+    }, Bench::DEFAULT_WARMUP_REPS, reps));
+
+    // a line is made then unmade (walks the history stack)
+    results.push_back(Bench::run_benchmark("make_unmake_line", num_line_moves, [&]{
+        uint64_t checksum = 0;
+        for (std::size_t ind = 0; ind < boards.size(); ++ind) {
+            for (const Move& move : lines[ind]) {
+                boards[ind]->make_move(move);
+            }
+            checksum += boards[ind]->get_zobrist_key();
+            for (std::size_t ply = 0; ply < lines[ind].size(); ++ply) {
+                boards[ind]->unmake_move();
+            }
+        }
+        return checksum;
+    }, Bench::DEFAULT_WARMUP_REPS, reps));
+
+    // same side positions since the last irreversible move
+    results.push_back(Bench::run_benchmark("is_repetition", shuffle_boards.size(), [&]{
+        uint64_t checksum = 0;
+        for (const auto& p_board : shuffle_boards) {
+            checksum += p_board->is_repetition();
+        }
+        return checksum;
+    }, Bench::DEFAULT_WARMUP_REPS, reps));
+
+    // cuckoo lookups of the positions one move away (all within the search)
+    results.push_back(Bench::run_benchmark("upcoming_repetition", shuffle_boards.size(), [&]{
+        uint64_t checksum = 0;
+        for (const auto& p_board : shuffle_boards) {
+            checksum += p_board->has_upcoming_repetition(Constants::MAX_SEARCH_PLY);
+        }
+        return checksum;
+    }, Bench::DEFAULT_WARMUP_REPS, reps));
+
+    // thread root setup, board copy vs fen round trip
+    auto p_clone_board = std::make_unique<Board>();
+    results.push_back(Bench::run_benchmark("board_clone", boards.size(), [&]{
+        uint64_t checksum = 0;
+        for (const auto& p_board : boards) {
+            p_board->clone_into(*p_clone_board);
+            checksum += p_clone_board->get_zobrist_key();
+        }
+        return checksum;
+    }, Bench::DEFAULT_WARMUP_REPS, reps));
+
+    results.push_back(Bench::run_benchmark("board_set_fen", boards.size(), [&]{
+        uint64_t checksum = 0;
+        for (const auto& p_board : boards) {
+            p_clone_board->set_fen(p_board->get_fen());
+            checksum += p_clone_board->get_zobrist_key();
+        }
+        return checksum;
+    }, Bench::DEFAULT_WARMUP_REPS, reps));
+
+    // every legal move of every position from its uci notation (position command moves)
+    std::vector<std::vector<std::string>> legal_notations(boards.size());
+    for (std::size_t ind = 0; ind < boards.size(); ++ind) {
+        for (const Move& move : legal_moves[ind]) {
+            legal_notations[ind].push_back(UCI::move_to_uci_notation(move));
+        }
+    }
+
+    results.push_back(Bench::run_benchmark("uci_notation_to_move", num_legal_moves, [&]{
+        uint64_t checksum = 0;
+        for (std::size_t ind = 0; ind < boards.size(); ++ind) {
+            for (const std::string& notation : legal_notations[ind]) {
+                checksum += UCI::uci_notation_to_move(notation, *boards[ind]).get_to_square();
+            }
+        }
+        return checksum;
+    }, Bench::DEFAULT_WARMUP_REPS, reps));
+
+    results.push_back(Bench::run_benchmark("evaluate", boards.size(), [&]{
+        uint64_t checksum = 0;
+        for (const auto& p_board : boards) {
+            checksum += evaluate(*p_board);
+        }
+        return checksum;
+    }, Bench::DEFAULT_WARMUP_REPS, reps));
+
+    results.push_back(Bench::run_benchmark("attacks_rook", NUM_RANDOM_OPS, [&]{
+        uint64_t checksum = 0;
+        for (std::size_t ind = 0; ind < NUM_RANDOM_OPS; ++ind) {
+            checksum += Attacks::attacks<PieceType::ROOK>(squares[ind], occupancies[ind]);
+        }
+        return checksum;
+    }, Bench::DEFAULT_WARMUP_REPS, reps));
+
+    results.push_back(Bench::run_benchmark("attacks_bishop", NUM_RANDOM_OPS, [&]{
+        uint64_t checksum = 0;
+        for (std::size_t ind = 0; ind < NUM_RANDOM_OPS; ++ind) {
+            checksum += Attacks::attacks<PieceType::BISHOP>(squares[ind], occupancies[ind]);
+        }
+        return checksum;
+    }, Bench::DEFAULT_WARMUP_REPS, reps));
+
+    // half of the probed keys are stored (hits)
+    results.push_back(Bench::run_benchmark("tt_probe", NUM_RANDOM_OPS, [&]{
+        uint64_t checksum = 0;
+        for (std::size_t ind = 0; ind < NUM_RANDOM_OPS; ++ind) {
+            checksum += tt.probe(keys[ind]).depth;
+        }
+        return checksum;
+    }, Bench::DEFAULT_WARMUP_REPS, reps));
+
+    results.push_back(Bench::run_benchmark("tt_store", NUM_RANDOM_OPS, [&]{
+        for (std::size_t ind = 0; ind < NUM_RANDOM_OPS; ++ind) {
+            tt.store(keys[ind], Move{}, Eval{0}, Depth{1}, NodeType::PV_NODE);
+        }
+        return uint64_t{0};
+    }, Bench::DEFAULT_WARMUP_REPS, reps));
+
+    // generation, scoring and sorting of all moves (engine tt is empty, so no tt move)
+    results.push_back(Bench::run_benchmark("movepicker_legal", boards.size(), [&]{
+        uint64_t checksum = 0;
+        for (const auto& p_board : boards) {
+            MovePicker<MoveGenType::LEGAL> move_picker(*p_board, *p_heuristics, killers);
+            checksum += move_picker.next_move().get_to_square();
+        }
+        return checksum;
+    }, Bench::DEFAULT_WARMUP_REPS, reps));
+
+    Bench::print_json(std::cout, results);
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+// move_ordering_bench.cpp
+// fixed depth search over a set of positions, reporting beta cutoff statistics
+// the first move cutoff rate (cutoffs on the first move / all cutoffs) measures move ordering quality
+//
+// usage: move_ordering_bench [depth]
+
+#include "defs.hpp"       // types, constants
+#include "utils.hpp"      // current_time
+#include "engine.hpp"     // engine globals (tt, thread pool, board)
+#include "searchinfo.hpp" // searchinfo
+
+#include <array>          // array
+#include <string>         // string
+#include <iostream>       // cout
+#include <iomanip>        // setw, setprecision
+
+using namespace MPChess;
+using namespace MPChess::Types;
+
+
+// FENs from: https://www.chessprogramming.org/Perft_Results
+inline constexpr std::array<const char*, 6> BENCH_FENS = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+};
+
+auto main(int argc, char* argv[]) -> int {
+
+    const std::size_t depth = (argc > 1) ? std::stoul(argv[1]) : 10;
+
+    uint64_t total_nodes              = 0;
+    uint64_t total_cutoffs            = 0;
+    uint64_t total_first_move_cutoffs = 0;
+
+    const auto start_time = current_time();
+
+    for (const char* fen : BENCH_FENS) {
+
+        // fresh state for every position (same as ucinewgame)
+        Engine::tt.reset();
+        Engine::thread_pool.clear_thread_data();
+        Engine::engine_board.set_fen(std::string(fen));
+
+        SearchInfo search_info;
+        search_info.start_time = current_time();
+        search_info.max_depth  = depth;
+
+        Engine::thread_pool.start_search(std::move(search_info));
+        Engine::thread_pool.wait_until_stopped();
+
+        const uint64_t nodes              = Engine::thread_pool.sum_threads(&EngineThread::get_node_counter);
+        const uint64_t cutoffs            = Engine::thread_pool.sum_threads(&EngineThread::get_cutoff_counter);
+        const uint64_t first_move_cutoffs = Engine::thread_pool.sum_threads(&EngineThread::get_first_move_cutoff_counter);
+
+        total_nodes              += nodes;
+        total_cutoffs            += cutoffs;
+        total_first_move_cutoffs += first_move_cutoffs;
+
+        std::cerr << std::setw(75) << std::left << fen
+                  << " nodes "   << std::setw(10) << nodes
+                  << " cutoffs " << std::setw(10) << cutoffs
+                  << " FMC "     << std::fixed << std::setprecision(2)
+                  << (cutoffs > 0 ? 100.0 * first_move_cutoffs / cutoffs : 0.0) << "%\n";
+    }
+
+    const auto time_spent = (current_time() - start_time).count();
+
+    std::cerr << "\n"
+              << "depth   " << depth                                                 << "\n"
+              << "nodes   " << total_nodes                                           << "\n"
+              << "time    " << time_spent                                            << " ms\n"
+              << "cutoffs " << total_cutoffs                                         << "\n"
+              << "FMC     " << 100.0 * total_first_move_cutoffs / total_cutoffs      << "%\n";
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+// thread_scaling_bench.cpp
+// smp scaling, fixed depth search over the bench positions with 1, 2, 4, ... max_threads threads
+// time to depth (search time until the main thread completed the depth) and nps are compared to 1 thread
+// threads use lazy smp, or abdada if the last argument is 1 (compare the time to depth of both)
+//
+// usage: thread_scaling_bench [depth] [max threads] [hash mb] [abdada]
+
+#include "defs.hpp"       // types, constants
+#include "utils.hpp"      // current_time
+#include "engine.hpp"     // engine globals (tt, thread pool, board)
+#include "searchinfo.hpp" // searchinfo
+#include "bench.hpp"      // bench positions
+
+#include <vector>         // vector
+#include <string>         // string
+#include <thread>         // hardware_concurrency
+#include <iostream>       // cout
+#include <iomanip>        // setw, setprecision
+#include <algorithm>      // max
+
+using namespace MPChess;
+using namespace MPChess::Types;
+
+
+auto main(int argc, char* argv[]) -> int {
+
+    const std::size_t depth        = (argc > 1) ? std::stoul(argv[1]) : 8;
+    const std::size_t max_threads  = (argc > 2) ? std::stoul(argv[2]) : std::max(std::thread::hardware_concurrency(), 1u);
+    const std::size_t hash_size_mb = (argc > 3) ? std::stoul(argv[3]) : Constants::DEFAULT_TABLE_SIZE_MB;
+
+    Engine::options.abdada = (argc > 4) && std::stoul(argv[4]) == 1;
+
+    std::vector<std::size_t> thread_counts;
+    for (std::size_t num_threads = 1; num_threads < max_threads; num_threads *= 2) {
+        thread_counts.push_back(num_threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    Engine::tt.resize(hash_size_mb);
+
+    double time_1_thread = 0;
+    double nps_1_thread  = 0;
+
+    std::cout << (Engine::options.abdada ? "abdada" : "lazy smp") << ", depth " << depth << "\n\n"
+              << std::setw(8)  << "threads"
+              << std::setw(12) << "time ms"
+              << std::setw(10) << "ttd x"
+              << std::setw(14) << "nodes"
+              << std::setw(12) << "nps"
+              << std::setw(10) << "nps x" << "\n";
+
+    for (const std::size_t num_threads : thread_counts) {
+        Engine::thread_pool.set_num_threads(num_threads);
+
+        uint64_t     total_nodes = 0;
+        Milliseconds total_time{0};
+
+        for (const char* fen : Constants::BENCH_FENS) {
+
+            // fresh state for every position (same as ucinewgame)
+            Engine::tt.reset();
+            Engine::abdada_table.reset();
+            Engine::thread_pool.clear_thread_data();
+            Engine::engine_board.set_fen(std::string(fen));
+
+            SearchInfo search_info;
+            search_info.start_time = current_time();
+            search_info.max_depth  = depth;
+
+            // bestmove/info output of the searches is not part of the report
+            std::cout.setstate(std::ios::failbit);
+            Engine::thread_pool.start_search(std::move(search_info));
+            Engine::thread_pool.wait_until_stopped();
+            std::cout.clear();
+
+            total_time  += current_time() - Engine::search_info.start_time;
+            total_nodes += Engine::thread_pool.sum_threads(&EngineThread::get_node_counter);
+        }
+
+        const double time_spent       = std::max<double>(total_time.count(), 1);
+        const double nodes_per_second = 1000. * total_nodes / time_spent;
+        if (num_threads == 1) {
+            time_1_thread = time_spent;
+            nps_1_thread  = nodes_per_second;
+        }
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(8)  << num_threads
+                  << std::setw(12) << total_time.count()
+                  << std::setw(10) << time_1_thread / time_spent
+                  << std::setw(14) << total_nodes
+                  << std::setw(12) << static_cast<uint64_t>(nodes_per_second)
+                  << std::setw(10) << nodes_per_second / nps_1_thread << std::endl;
+    }
+
+    return 0;
+}
\ No newline at end of file
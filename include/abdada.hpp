@@ -0,0 +1,60 @@
+// abdada.hpp
+// ABDADA parallel search work division (https://www.chessprogramming.org/ABDADA)
+//
+// simplified variant: a small lock-free table of the positions threads are currently searching
+// a thread defers a move (other than the first) into a position another thread is already searching,
+// and searches it after its other moves, by then usually a tt hit
+// entries only steer which moves are searched first, so lost updates (races, index collisions) are harmless
+
+#pragma once
+
+#include "defs.hpp" // types, constants
+
+#include <array>    // array
+#include <atomic>   // atomic
+
+
+namespace MPChess {
+
+namespace Constants {
+
+inline constexpr std::size_t  ABDADA_TABLE_SIZE = 1 << 15;
+inline constexpr Types::Depth ABDADA_MIN_DEPTH  = 3; // shallower moves are cheaper to search twice than to defer
+
+} // Constants namespace
+
+
+class AbdadaTable {
+private:
+
+    std::array<std::atomic<Types::Key>, Constants::ABDADA_TABLE_SIZE> keys{};
+
+    static std::size_t index(Types::Key key) {
+        return key & (Constants::ABDADA_TABLE_SIZE - 1);
+    }
+
+public:
+
+    // position with key is being searched by some thread
+    bool is_searching(Types::Key key) const {
+        return this->keys[index(key)].load(std::memory_order_relaxed) == key;
+    }
+
+    void start_search(Types::Key key) {
+        this->keys[index(key)].store(key, std::memory_order_relaxed);
+    }
+
+    // clears the entry, unless it was overwritten by another position
+    void finish_search(Types::Key key) {
+        Types::Key expected = key;
+        this->keys[index(key)].compare_exchange_strong(expected, Types::Key{0}, std::memory_order_relaxed);
+    }
+
+    void reset() {
+        for (std::atomic<Types::Key>& key : this->keys) {
+            key.store(Types::Key{0}, std::memory_order_relaxed);
+        }
+    }
+};
+
+} // MPChess namespace
\ No newline at end of file
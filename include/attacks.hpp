@@ -3,20 +3,35 @@
 #pragma once
 
 #include "defs.hpp"  // types, constants
-#include "utils.hpp" // utils (step, shift, square_to_bitboard, rank_bitboard, file_bitboard)
+#include "utils.hpp"  // utils (step, shift, square_to_bitboard, rank_bitboard, file_bitboard)
+#include "magics.hpp" // precomputed magic numbers
 
-#include "rng.hpp"   // xorshift64
+#include <array>      // array
 
-#include <array>     // array
-#include <vector>    // vector
-
-#include <iostream>  // cout
+// slider attacks are indexed with pext when compiled with bmi2 (e.g. -march=native)
+// magics are the fallback, or can be forced by defining MPCHESS_NO_PEXT (e.g. slow pext on older AMD cpus)
+#if defined(__BMI2__) && !defined(MPCHESS_NO_PEXT)
+#define MPCHESS_USE_PEXT
+#include <immintrin.h> // _pext_u64
+#endif
 
 
 namespace MPChess {
 
 namespace Attacks {
 
+// slider lookup backends
+enum class SliderBackend {
+    MAGIC,
+    PEXT
+};
+
+#ifdef MPCHESS_USE_PEXT
+inline constexpr SliderBackend DEFAULT_SLIDER_BACKEND = SliderBackend::PEXT;
+#else
+inline constexpr SliderBackend DEFAULT_SLIDER_BACKEND = SliderBackend::MAGIC;
+#endif
+
 // pawn attacks
 template<Types::Color c, Concepts::bitboard_like BB_t>
 requires (c != Types::Color::NO_COLOR)
@@ -142,262 +157,88 @@ constexpr Types::Bitboard relevant_blocker_mask(Types::Square sq) {
 
 namespace Magics {
 
-struct MagicEntry {
-    Types::Bitboard blockers_mask;
-    uint64_t        magic;
-    std::size_t     key_shift;
-    std::size_t     table_offset;
+// lookup entry of a slider on one square
+// everything needed for a lookup shares one cache line (two entries per line)
+struct alignas(32) MagicEntry {
+    Types::Bitboard        blockers_mask;
+    uint64_t               magic;     // unused by pext
+    const Types::Bitboard* attacks;   // attacks of this square, indexed by magic/pext key
+    std::size_t            key_shift; // unused by pext
 
+    template<SliderBackend backend>
     inline std::size_t get_index(Types::Bitboard occupancy) const {
-        occupancy &= this->blockers_mask;
-        const int key = (this->magic * occupancy) >> this->key_shift;
-        return key + this->table_offset;
-    }
-};
-
-using MagicTable = std::vector<MagicEntry>;
-
-
-// find magics
-template<Types::PieceType slider, bool optimize=false>
-requires (slider == Types::PieceType::BISHOP) || (slider == Types::PieceType::ROOK)
-MagicEntry find_magic(Types::Square sq, 
-                      std::vector<Types::Bitboard>* const p_attack_table=nullptr,
-                      std::size_t iterations=100000000,
-                      Rng::XorShift64& rng=Rng::main_rng) {
-
-    // get relevant blocker squares and shift used for hashing
-    const Types::Bitboard relevant_blockers = relevant_blocker_mask<slider>(sq);
-    const std::size_t     bit_count         = pop_count(relevant_blockers);
-    std::size_t           key_shift         = 64 - bit_count;
-
-    // find magics using brute force
-    //
-    // try a magic by generating a random, sparse (not many 1 bits) 64-bit number
-    // a magic is valid if it correctly maps the attacks of all possible blocker
-    // configurations for the sliding piece on a given square
-    // the relevant blocker squares are all the squares a blocker can be on
-    // to validate a magic is valid, need to generate every blocker combination/subset
-    // and use the magic number to hash the subset
-    // if the magic number can hash each subset without any destructive collisions
-    // then the magic is valid
-    //
-    // a destructive collision is when a magic hashes multiple blocker
-    // combinations to the same hash key when the block combinations have
-    // different attack sets
-    // 
-    // a constructive collision is okay i.e. when the magic hashes multiple different
-    // blocker combinations to the same hash key, but the blocker combinations
-    // have the same attack set (e.g. a bishop on a1 will have the same attack
-    // set if there are blockers on [e4, f4, g6] or [e4, g6] or [e4, h8] or ...)
-    //
-    // the hashing function is (magic_bitboard * blockers_bitboard) >> (64 - N)
-    // where N is the number of bits used for a hash key
-    // it is easy to find magic numbers for N = number of blockers in the relevant blocker mask
-    // it is possible to find some magics for some squares where N < number of blockers in relevant mask
-    // but computationally it is much harder
-    // a smaller N just means a smaller final lookup table
-
-    // first generate all possible blocker subsets and corresponding attack sets
-    // will generate subsets using "Carry-Ripple" iteration
-
-    std::vector<Types::Bitboard> blocker_subsets;
-    blocker_subsets.reserve(1 << bit_count);
-
-    std::vector<Types::Bitboard> attack_subsets;
-    attack_subsets.reserve(1 << bit_count);
-
-    // carry-ripple iteration
-    Types::Bitboard blocker_subset{Constants::EMPTY};
-    do {
-        blocker_subset = (blocker_subset - relevant_blockers) & relevant_blockers;
-        const Types::Bitboard attacks = slider_attacks<slider>(sq, blocker_subset);
-
-        blocker_subsets.push_back(blocker_subset);
-        attack_subsets.push_back(attacks);
-
-    } while(blocker_subset);
-
-    // hash function
-    auto hasher = [](uint64_t magic, Types::Bitboard blockers, std::size_t key_shift) -> int {
-        return (magic * blockers) >> key_shift;
-    };
-
-    // find magics
-    Types::Bitboard    best_magic{Constants::EMPTY};
-    std::size_t best_hash_size = (1 << bit_count) + 1;
-
-    // mapped attacks
-    // initialize to empty (no piece/square/blocker combo has an empty attack set)
-    std::vector<Types::Bitboard> mapped_attacks(1 << bit_count, Constants::EMPTY);
-
-    bool repeat_magic = false; // used to repeat best_magic with larger key_shift
-    std::size_t iter=0;
-    while (iter++ <= iterations) {
-
-        // generate candidate magic
-        Types::Bitboard magic = (!repeat_magic) ? rng.generate<Rng::RngType::SPARSE>() : best_magic;
-
-        bool invalid_magic = false;
-        std::size_t hash_size = 0;
-
-        // reset mapped attacks
-        std::fill(mapped_attacks.begin(), mapped_attacks.end(), Constants::EMPTY);
-
-        // loop over all blocker subsets and hash
-        // make sure no destructive collisions
-        for (std::size_t i=0; i<blocker_subsets.size(); ++i) {
-
-            const int hash_key = hasher(magic, blocker_subsets[i], key_shift);
-
-            // unmapped attacks
-            if (mapped_attacks[hash_key] == Constants::EMPTY) {
-
-                mapped_attacks[hash_key] = attack_subsets[i];
-                ++hash_size;
-
-                // if current hash size is larger then the best hash size so far,
-                // restart to try and find magic with more collisions
-                if (hash_size > best_hash_size) {
-                    invalid_magic = true;
-                    break;
-                }
-            }
-            // constructive collision
-            else if (mapped_attacks[hash_key] == attack_subsets[i]) {
-
-            }
-            // destructive collision -- start over with new magic candidate
-            else {
-                invalid_magic = true;
-                break;
-            }
-        }
-
-        // if magic found
-        if (!invalid_magic) {
-
-            if constexpr (optimize) {
-                std::cout << "\tIter: " << iter << " / " << iterations << "\n";
-                std::cout << "\tFound magic with hash size: " << hash_size << "\n";
-                std::cout << "\tMagic: " << magic << "\n";
-                std::cout << "\tPiece/Types::Square: " << Constants::PIECE_LABELS[slider] << " / " << square_to_notation(sq) << "\n\n";
-            }
-
-            // if better than previous magic
-            if (hash_size < best_hash_size) {
-
-                // update best magic
-                best_magic = magic;
-                best_hash_size = hash_size;
-
-                // if optimization flag not set just return first found valid magic
-                if constexpr (!optimize) {
-                    break;
-                }
-
-                // revalidate magic using larger key_shift
-                // TODO : maybe only do this if hash_size is near half 2^(bit_count)
-                repeat_magic = true;
-                ++key_shift;
-                --iter;
-            }
+        if constexpr (backend == SliderBackend::PEXT) {
+#ifdef MPCHESS_USE_PEXT
+            return _pext_u64(occupancy, this->blockers_mask);
+#else
+            static_assert(backend != SliderBackend::PEXT, "pext lookups need bmi2");
+#endif
         }
-
-        // if failed to revalidate with bigger key shift
-        if (repeat_magic) {
-            repeat_magic = false;
-            
-            // change key_shift back to last valid size
-            if (invalid_magic) {
-                --key_shift;
-            }
+        else {
+            occupancy &= this->blockers_mask;
+            return (this->magic * occupancy) >> this->key_shift;
         }
     }
+};
 
-    std::size_t table_offset = 0;
-    if (p_attack_table != nullptr) {
-
-        table_offset = p_attack_table->size();
-
-        p_attack_table->insert(p_attack_table->end(),
-                               mapped_attacks.begin(),
-                               mapped_attacks.end());
-    }
+using MagicTable = std::array<MagicEntry, Constants::NUM_SQUARES>;
 
-    return {relevant_blockers, best_magic, key_shift, table_offset};
+// magic numbers of a slider (from magics.hpp)
+template<Types::PieceType slider>
+requires (slider == Types::PieceType::BISHOP) || (slider == Types::PieceType::ROOK)
+constexpr const MagicNumbers& magic_numbers() {
+    return (slider == Types::PieceType::BISHOP) ? BISHOP_MAGIC_NUMBERS : ROOK_MAGIC_NUMBERS;
 }
 
-
-// generate magics
-template<Types::PieceType slider>
+// number of attack sets of a slider over all squares
+// magic tables are 2^(64 - shift) per square, pext tables are 2^(relevant blockers) per square
+template<Types::PieceType slider, SliderBackend backend>
 requires (slider == Types::PieceType::BISHOP) || (slider == Types::PieceType::ROOK)
-MagicTable generate_magics() {
+consteval std::size_t slider_table_size() {
 
-    MagicTable magic_table(Constants::NUM_SQUARES);
-    std::size_t offset = 0; // offset each square by hash size of previous squares
+    std::size_t table_size = 0;
     for (const Types::Square& sq : Constants::ALL_SQUARES) {
-        
-        MagicEntry magic_entry = Magics::find_magic<slider>(sq);
-        magic_entry.table_offset = offset;
-
-        const std::size_t key_size  = 64 - magic_entry.key_shift;
-        const std::size_t hash_size = (1 << key_size);
-        offset += hash_size;
-
-        magic_table[sq] = magic_entry;
+        if constexpr (backend == SliderBackend::MAGIC) {table_size += 1ull << (64 - magic_numbers<slider>()[sq].key_shift);}
+        else                                           {table_size += 1ull << pop_count(relevant_blocker_mask<slider>(sq));}
     }
 
-    return magic_table;
+    return table_size;
 }
 
-} // Magics namespace
-
+// bishop and rook attacks share one contiguous table per backend (bishops first)
+template<SliderBackend backend>
+inline constexpr std::size_t SLIDER_ATTACKS_SIZE = slider_table_size<Types::PieceType::BISHOP, backend>()
+                                                 + slider_table_size<Types::PieceType::ROOK,   backend>();
 
-namespace Tables {
+template<SliderBackend backend>
+using SliderAttacks = std::array<Types::Bitboard, SLIDER_ATTACKS_SIZE<backend>>;
 
-inline Magics::MagicTable BISHOP_MAGICS = Magics::generate_magics<Types::PieceType::BISHOP>();
-inline Magics::MagicTable ROOK_MAGICS   = Magics::generate_magics<Types::PieceType::ROOK>();
-
-// generate sliding attack table
-template<Types::PieceType slider>
-requires (slider == Types::PieceType::BISHOP) || (slider == Types::PieceType::ROOK)
-std::vector<Types::Bitboard> generate_sliding_attack_table(const Magics::MagicTable& magic_table) {
-
-    // calculate table size
-    std::size_t table_size = 0;
-    for (const Magics::MagicEntry& magic_entry : magic_table) {
-        
-        const std::size_t key_size  = (64 - magic_entry.key_shift);
-        const std::size_t hash_size = (1 << key_size);
-        table_size += hash_size;
-    }
-
-    // generate attacks for each blocker subset
-    std::vector<Types::Bitboard> attack_table(table_size);
-    for (const Types::Square& sq : Constants::ALL_SQUARES) {
+} // Magics namespace
 
-        const auto& [relevant_blockers,
-                     magic,
-                     key_shift,
-                     table_offset] = magic_table[sq];
 
-        // iterate over all blocker subsets
-        Types::Bitboard blocker_subset{Constants::EMPTY};
-        do {
+namespace Tables {
 
-            blocker_subset = (blocker_subset - relevant_blockers) & relevant_blockers;
+// slider lookup entries
+// entries and attacks are generated at compile time (attacks.cpp), so they are
+// read-only data shared by all engine processes and need no startup work
+// magic tables are always built (fallback, benchmarks), pext tables only with bmi2
+extern const Magics::MagicTable BISHOP_MAGIC_ENTRIES;
+extern const Magics::MagicTable ROOK_MAGIC_ENTRIES;
 
-            // generate attacks for blocker subset
-            const Types::Bitboard attacks = slider_attacks<slider>(sq, blocker_subset);
-            const int hash_key = (magic * blocker_subset) >> key_shift;
+#ifdef MPCHESS_USE_PEXT
+extern const Magics::MagicTable BISHOP_PEXT_ENTRIES;
+extern const Magics::MagicTable ROOK_PEXT_ENTRIES;
+#endif
 
-            // store in table
-            attack_table[hash_key + table_offset] = attacks;
-        } while (blocker_subset);
+template<Types::PieceType slider, SliderBackend backend>
+requires (slider == Types::PieceType::BISHOP) || (slider == Types::PieceType::ROOK)
+inline const Magics::MagicTable& slider_entries() {
+#ifdef MPCHESS_USE_PEXT
+    if constexpr (backend == SliderBackend::PEXT) {
+        return (slider == Types::PieceType::BISHOP) ? BISHOP_PEXT_ENTRIES : ROOK_PEXT_ENTRIES;
     }
-
-    return attack_table;
+#endif
+    return (slider == Types::PieceType::BISHOP) ? BISHOP_MAGIC_ENTRIES : ROOK_MAGIC_ENTRIES;
 }
 
 // pawn attack table
@@ -438,12 +279,6 @@ inline constexpr std::array<Types::Bitboard, Constants::NUM_SQUARES> KING_ATTACK
     return attacks;
 }();
 
-// bishop attack table
-inline std::vector<Types::Bitboard> BISHOP_ATTACK_TABLE = generate_sliding_attack_table<Types::PieceType::BISHOP>(BISHOP_MAGICS);
-
-// rook attack table
-inline std::vector<Types::Bitboard> ROOK_ATTACK_TABLE = generate_sliding_attack_table<Types::PieceType::ROOK>(ROOK_MAGICS);
-
 // inbetween squares table
 inline constexpr std::array<std::array<Types::Bitboard, Constants::NUM_SQUARES>, Constants::NUM_SQUARES> INBETWEEN_SQUARES_TABLE = [] consteval {
 
@@ -469,28 +304,49 @@ inline constexpr std::array<std::array<Types::Bitboard, Constants::NUM_SQUARES>,
     return inbetween_squares;
 }();
 
+// line table
+inline constexpr std::array<std::array<Types::Bitboard, Constants::NUM_SQUARES>, Constants::NUM_SQUARES> LINE_TABLE = [] consteval {
+
+    std::array<std::array<Types::Bitboard, Constants::NUM_SQUARES>, Constants::NUM_SQUARES> lines;
+
+    // if squares are on same line (diag/row/col)
+    // then the full line is the overlap of empty board bishop/rook attacks
+    // from each square (plus both squares)
+    for (const Types::Square& sq_1 : Constants::ALL_SQUARES) {
+        for (const Types::Square& sq_2 : Constants::ALL_SQUARES) {
+
+            const bool diag_aligned   = slider_attacks<Types::PieceType::BISHOP>(sq_1, Constants::EMPTY) & square_to_bitboard(sq_2);
+            const bool rowcol_aligned = slider_attacks<Types::PieceType::ROOK>(sq_1, Constants::EMPTY)   & square_to_bitboard(sq_2);
+
+            const Types::Bitboard diag_line   = diag_aligned   ? slider_attacks<Types::PieceType::BISHOP>(sq_1, Constants::EMPTY) & slider_attacks<Types::PieceType::BISHOP>(sq_2, Constants::EMPTY) : Constants::EMPTY;
+            const Types::Bitboard rowcol_line = rowcol_aligned ? slider_attacks<Types::PieceType::ROOK>(sq_1, Constants::EMPTY)   & slider_attacks<Types::PieceType::ROOK>(sq_2, Constants::EMPTY)   : Constants::EMPTY;
+
+            lines[sq_1][sq_2] = (diag_aligned || rowcol_aligned)
+                              ? (diag_line | rowcol_line | square_to_bitboard(sq_1) | square_to_bitboard(sq_2))
+                              : Constants::EMPTY;
+        }
+    }
+
+    return lines;
+}();
+
 } // Tables namespace
 
 
 // slider attacks lookup
-template<Types::PieceType pt, Concepts::bitboard_like BB_t>
+template<Types::PieceType pt, SliderBackend backend = DEFAULT_SLIDER_BACKEND, Concepts::bitboard_like BB_t>
 requires (pt == Types::PieceType::BISHOP) || (pt == Types::PieceType::ROOK) || (pt == Types::PieceType::QUEEN)
 Types::Bitboard slider_attacks_lookup(BB_t pieces, Types::Bitboard occupancy) {
 
     if constexpr (pt == Types::PieceType::QUEEN) {
-        return slider_attacks_lookup<Types::PieceType::BISHOP>(pieces, occupancy)
-             | slider_attacks_lookup<Types::PieceType::ROOK>(pieces, occupancy);
+        return slider_attacks_lookup<Types::PieceType::BISHOP, backend>(pieces, occupancy)
+             | slider_attacks_lookup<Types::PieceType::ROOK,   backend>(pieces, occupancy);
     }
 
     // square input (lookup)
-    if constexpr (std::same_as<Types::Square, BB_t>) {
-        const Magics::MagicEntry& magic_entry = (pt == Types::PieceType::BISHOP) ? Tables::BISHOP_MAGICS[pieces]
-                                                                                 : Tables::ROOK_MAGICS[pieces];
-
-        const std::size_t index = magic_entry.get_index(occupancy);
-
-        return (pt == Types::PieceType::BISHOP) ? Tables::BISHOP_ATTACK_TABLE[index]
-                                                : Tables::ROOK_ATTACK_TABLE[index];
+    else if constexpr (std::same_as<Types::Square, BB_t>) {
+        const Magics::MagicEntry& entry = Tables::slider_entries<pt, backend>()[pieces];
+        return entry.attacks[entry.get_index<backend>(occupancy)];
     }
 
     // bitboard input (iterate over squares lookup)
@@ -499,7 +355,7 @@ Types::Bitboard slider_attacks_lookup(BB_t pieces, Types::Bitboard occupancy) {
         Types::Bitboard attacks = Constants::EMPTY;
         while(pieces) {
             const Types::Square sq = pop_lsb(pieces);
-            attacks |= slider_attacks_lookup<pt>(sq, occupancy);
+            attacks |= slider_attacks_lookup<pt, backend>(sq, occupancy);
         }
 
         return attacks;
@@ -534,6 +390,11 @@ constexpr Types::Bitboard inbetween_squares(Types::Square sq_1, Types::Square sq
     return Tables::INBETWEEN_SQUARES_TABLE[sq_1][sq_2];
 }
 
+// full line through both squares lookup (empty if not aligned)
+constexpr Types::Bitboard line_through(Types::Square sq_1, Types::Square sq_2) {
+    return Tables::LINE_TABLE[sq_1][sq_2];
+}
+
 
 } // Attacks namespace
 
@@ -7,8 +7,10 @@
 #include "movelist.hpp"  // movelist
 
 #include "attacks.hpp"   // attacks
+#include "zobrist.hpp"   // zobrist hashes
 
 #include <array>         // array
+#include <vector>        // vector
 #include <string_view>   // string_view
 
 #include <iostream>      // ostream, cout
@@ -16,37 +18,104 @@
 
 namespace MPChess {
 
+namespace Types {
+
+// check information of the side to move, computed once per node (see Board::gives_check)
+struct CheckInfo {
+    Square                                         enemy_king;
+    Bitboard                                       discover_candidates; // friendly pieces blocking a friendly slider from the enemy king
+    std::array<Bitboard, Constants::NUM_PIECE_TYPES> check_squares;     // squares each piece type gives direct check from
+};
+
+// a ply of history: the move and the state it can not be undone from (16 bytes)
+struct StateInfo {
+    Key      zobrist_key;
+    Move     move;
+    uint16_t ply_clock;
+    Square   enpassant_square;
+    Castle   castling_rights;
+
+    Piece    piece_moved;
+    Piece    piece_captured;
+};
+
+} // Types namespace
+
+
+namespace Constants {
+
+// castling rights kept when a piece moves from or to a square (rights are lost when a king or rook moves or a rook is captured)
+inline constexpr std::array<Types::Castle, NUM_SQUARES> CASTLING_RIGHTS_MASKS = []{
+
+    std::array<Types::Castle, NUM_SQUARES> masks;
+    masks.fill(CastlingRights::ALL);
+
+    masks[Types::Square::E1] = CastlingRights::B_BOTH;
+    masks[Types::Square::A1] = CastlingRights::W_SHORT_B_BOTH;
+    masks[Types::Square::H1] = CastlingRights::W_LONG_B_BOTH;
+    masks[Types::Square::E8] = CastlingRights::W_BOTH;
+    masks[Types::Square::A8] = CastlingRights::W_BOTH_B_SHORT;
+    masks[Types::Square::H8] = CastlingRights::W_BOTH_B_LONG;
+
+    return masks;
+}();
+
+} // Constants namespace
+
+
 class Board {
 private:
 
     // board
 
-    std::array<Types::Piece, Constants::NUM_SQUARES>     pieces;
-    std::array<Types::Bitboard, Constants::NUM_PIECES>   piece_bbs;
-    std::array<Types::Bitboard, Constants::NUM_COLORS+1> occupancy_bbs;
+    // piece bitboards are type & color bitboards
+
+    std::array<Types::Bitboard, Constants::NUM_PIECE_TYPES> type_bbs;
+    std::array<Types::Bitboard, Constants::NUM_COLORS+1>    occupancy_bbs; // white, black, unoccupied
+    std::array<Types::Piece, Constants::NUM_SQUARES>        pieces;
 
 
     // game state variables
 
+    Types::Key    zobrist_key;
+    uint32_t      ply_played;
+    uint32_t      ply_move_number;
+    uint16_t      ply_clock;
     Types::Color  side_to_move;
-    std::size_t   ply_clock;
-    std::size_t   ply_played;
-    std::size_t   ply_move_number;
     Types::Square enpassant_square;
     Types::Castle castling_rights;
-    Types::Key    zobrist_key;
 
 
     // state/move history
+    // sized to the moves played plus a search (MAX_SEARCH_PLY), grown when a game outlasts it
 
-    std::array<Types::StateInfo, Constants::MAX_PLY> state_history;
-    RegularMoveList                                  move_list;
+    std::vector<Types::StateInfo> state_history;
 
 
     // generate zobrist key
 
     void generate_key();
 
+
+    // add state to history
+
+    void push_state(const Types::StateInfo& state);
+
+
+    // make/unmake move per color and kind of move (make_move/unmake_move dispatch to these)
+
+    template<Types::Color side>
+    void make_move(Move move);
+
+    template<Types::Color side, Types::MoveKind kind>
+    void make_move(Move move);
+
+    template<Types::Color side>
+    void unmake_move(Move move);
+
+    template<Types::Color side, Types::MoveKind kind>
+    void unmake_move(Move move);
+
 public:
 
     // constructors
@@ -54,11 +123,14 @@ public:
     Board();
     Board(std::string&& fen);
 
-    
-    // no copying
 
-    Board(const Board& board)             = delete;
-    Board& operator= (const Board& board) = delete;
+    // copying
+    // only the live part of the state/move history (ply_played entries) is copied
+
+    Board(const Board& board);
+    Board& operator= (const Board& board);
+
+    void clone_into(Board& board) const;
 
 
     // set/get fen
@@ -90,13 +162,13 @@ public:
     std::size_t     get_full_move_number() const;
     Types::Key      get_zobrist_key()      const;
 
-    const RegularMoveList& get_move_list() const;
+    Move                   get_previous_move(std::size_t plies_ago = 1)        const;
+    Types::Piece           get_previous_moved_piece(std::size_t plies_ago = 1) const;
 
     template<Types::Color side>
     requires (side != Types::Color::NO_COLOR)
     Types::Square get_king_square() const {
-        const Types::Piece king = color_type_to_piece(side, Types::PieceType::KING);
-        return bitboard_to_square(this->piece_bbs[king]);
+        return bitboard_to_square(this->type_bbs[Types::PieceType::KING] & this->occupancy_bbs[side]);
     }
 
 
@@ -107,16 +179,57 @@ public:
     void make_null_move();
     void unmake_null_move();
 
-    void update_enpassant_square(Move move);
-    void update_castling_rights(Move move);
-
     Types::Square captured_square(Move move) const;
     Types::Piece  captured_piece(Move move)  const;
     Types::Piece  moved_piece(Move move)     const;
 
-    void remove_piece(Types::Square sq);
-    void add_piece(Types::Square sq, Types::Piece p);
-    void move_piece(Types::Square from, Types::Square to);
+
+    // add/remove/move pieces
+    // unmake restores the key from history, so it skips the key updates (update_key = false)
+
+    template<bool update_key = true>
+    void remove_piece(Types::Square sq) {
+        const Types::Piece p = this->pieces[sq];
+
+        this->pieces[sq]                              = Types::Piece::NO_PIECE;
+        this->type_bbs[piece_type(p)]                ^= square_to_bitboard(sq);
+        this->occupancy_bbs[piece_color(p)]          ^= square_to_bitboard(sq);
+        this->occupancy_bbs[Types::Color::NO_COLOR]  |= square_to_bitboard(sq);
+
+        if constexpr (update_key) {
+            this->zobrist_key ^= Zobrist::get_piece_square_key(p, sq);
+        }
+    }
+
+    template<bool update_key = true>
+    void add_piece(Types::Square sq, Types::Piece p) {
+        this->pieces[sq]                              = p;
+        this->type_bbs[piece_type(p)]                |= square_to_bitboard(sq);
+        this->occupancy_bbs[piece_color(p)]          |= square_to_bitboard(sq);
+        this->occupancy_bbs[Types::Color::NO_COLOR]  ^= square_to_bitboard(sq);
+
+        if constexpr (update_key) {
+            this->zobrist_key ^= Zobrist::get_piece_square_key(p, sq);
+        }
+    }
+
+    template<bool update_key = true>
+    void move_piece(Types::Square from, Types::Square to) {
+        const Types::Piece    p       = this->pieces[from];
+        const Types::Bitboard from_to = square_to_bitboard(from) | square_to_bitboard(to);
+
+        this->pieces[from] = Types::Piece::NO_PIECE;
+        this->pieces[to]   = p;
+
+        this->type_bbs[piece_type(p)]                ^= from_to;
+        this->occupancy_bbs[piece_color(p)]          ^= from_to;
+        this->occupancy_bbs[Types::Color::NO_COLOR]  ^= from_to;
+
+        if constexpr (update_key) {
+            this->zobrist_key ^= Zobrist::get_piece_square_key(p, from)
+                              ^  Zobrist::get_piece_square_key(p, to);
+        }
+    }
 
 
     // validate board
@@ -126,15 +239,21 @@ public:
     void            validate()               const;
     bool            is_repetition()          const;
 
+    // the side to move can repeat a position within the search (ply plies deep) with its next move
+    bool            has_upcoming_repetition(std::size_t ply) const;
+
 
     // attacks
 
     template<Concepts::bitboard_like BB_t>
     Types::Bitboard attacks_to(BB_t bb) const {
+        return this->attacks_to(bb, ~(this->occupancy_bbs[Types::Color::NO_COLOR]));
+    }
 
-        if (is_empty(bb)) {return Constants::EMPTY;}
+    template<Concepts::bitboard_like BB_t>
+    Types::Bitboard attacks_to(BB_t bb, Types::Bitboard occupancy) const {
 
-        const Types::Bitboard occupancy = ~(this->occupancy_bbs[Types::Color::NO_COLOR]);
+        if (is_empty(bb)) {return Constants::EMPTY;}
 
         return (Attacks::attacks<Types::PieceType::PAWN, Types::Color::WHITE>(bb) & this->get_piece_bb(Types::Piece::B_PAWN))
              | (Attacks::attacks<Types::PieceType::PAWN, Types::Color::BLACK>(bb) & this->get_piece_bb(Types::Piece::W_PAWN))
@@ -156,6 +275,13 @@ public:
 
         return !is_empty(checkers);
     }
+
+
+    // checks given by the side to move (without make/unmake)
+
+    Types::CheckInfo get_check_info()                                          const;
+    bool             gives_check(Move move, const Types::CheckInfo& check_info) const;
+    bool             gives_check(Move move)                                     const;
 };
 
 // non-member operators
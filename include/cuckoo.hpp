@@ -0,0 +1,106 @@
+// cuckoo.hpp
+
+#pragma once
+
+#include "defs.hpp"    // types, constants
+#include "utils.hpp"   // piece_type, square_to_bitboard
+#include "attacks.hpp" // attacks on an empty board
+#include "zobrist.hpp" // zobrist hashes
+
+#include <array>       // array
+#include <utility>     // swap
+
+
+namespace MPChess {
+
+namespace Constants {
+
+inline constexpr std::size_t CUCKOO_TABLE_SIZE = 8192;
+inline constexpr std::size_t NUM_CUCKOO_MOVES  = 3668; // non-pawn piece moves between two squares on an empty board
+
+} // Constants namespace
+
+
+namespace Cuckoo {
+
+    // cuckoo tables of reversible moves (upcoming repetition detection, see Board::has_upcoming_repetition)
+    // every non-pawn piece move between two squares is stored under the key difference it makes
+    // (piece square keys of both squares and the color key), in one of the two slots given by hash_1/hash_2
+    // so the move that turns one position into another (if any) is found from the two keys
+    struct CuckooTable {
+        std::array<Types::Key,    Constants::CUCKOO_TABLE_SIZE> keys;
+        std::array<Types::Square, Constants::CUCKOO_TABLE_SIZE> from_squares;
+        std::array<Types::Square, Constants::CUCKOO_TABLE_SIZE> to_squares;
+    };
+
+    constexpr std::size_t hash_1(Types::Key key) {
+        return key & (Constants::CUCKOO_TABLE_SIZE - 1);
+    }
+
+    constexpr std::size_t hash_2(Types::Key key) {
+        return (key >> 16) & (Constants::CUCKOO_TABLE_SIZE - 1);
+    }
+
+    inline constexpr CuckooTable CUCKOO_TABLE = [] consteval {
+
+        CuckooTable table{};
+        table.from_squares.fill(Types::Square::NO_SQUARE);
+        table.to_squares.fill(Types::Square::NO_SQUARE);
+
+        std::size_t num_moves = 0;
+
+        for (const Types::Piece& p : Constants::ALL_PIECES) {
+
+            const Types::PieceType pt = piece_type(p);
+            if (pt == Types::PieceType::PAWN) {continue;}
+
+            for (const Types::Square& sq_1 : Constants::ALL_SQUARES) {
+
+                const Types::Bitboard attacks = (pt == Types::PieceType::KNIGHT) ? Attacks::knight_attacks(sq_1)
+                                              : (pt == Types::PieceType::BISHOP) ? Attacks::slider_attacks<Types::PieceType::BISHOP>(sq_1, Constants::EMPTY)
+                                              : (pt == Types::PieceType::ROOK)   ? Attacks::slider_attacks<Types::PieceType::ROOK>(sq_1, Constants::EMPTY)
+                                              : (pt == Types::PieceType::QUEEN)  ? Attacks::slider_attacks<Types::PieceType::QUEEN>(sq_1, Constants::EMPTY)
+                                              :                                    Attacks::king_attacks(sq_1);
+
+                for (const Types::Square& sq_2 : Constants::ALL_SQUARES) {
+                    if (sq_2 <= sq_1 || !(attacks & square_to_bitboard(sq_2))) {continue;}
+
+                    Types::Key    key  = Zobrist::get_piece_square_key(p, sq_1)
+                                       ^ Zobrist::get_piece_square_key(p, sq_2)
+                                       ^ Zobrist::get_color_key();
+                    Types::Square from = sq_1;
+                    Types::Square to   = sq_2;
+
+                    // insert, moving any displaced entry to its other slot until an empty slot is reached
+                    std::size_t index = hash_1(key);
+                    while (true) {
+                        std::swap(table.keys[index],         key);
+                        std::swap(table.from_squares[index], from);
+                        std::swap(table.to_squares[index],   to);
+
+                        if (key == 0) {break;}
+
+                        index = (index == hash_1(key)) ? hash_2(key) : hash_1(key);
+                    }
+
+                    ++num_moves;
+                }
+            }
+        }
+
+        if (num_moves != Constants::NUM_CUCKOO_MOVES) {throw "unexpected number of cuckoo moves";}
+
+        return table;
+    }();
+
+
+    // index of key in the table, CUCKOO_TABLE_SIZE if not stored
+    constexpr std::size_t find(Types::Key key) {
+        if (CUCKOO_TABLE.keys[hash_1(key)] == key) {return hash_1(key);}
+        if (CUCKOO_TABLE.keys[hash_2(key)] == key) {return hash_2(key);}
+        return Constants::CUCKOO_TABLE_SIZE;
+    }
+
+} // Cuckoo namespace
+
+} // MPChess namespace
\ No newline at end of file
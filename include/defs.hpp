@@ -34,7 +34,7 @@ using MoveScore = uint32_t;
 using Eval = int16_t;
 using Depth = uint16_t;
 
-enum Square : int {
+enum Square : uint8_t {
     A1, B1, C1, D1, E1, F1, G1, H1,
     A2, B2, C2, D2, E2, F2, G2, H2,
     A3, B3, C3, D3, E3, F3, G3, H3,
@@ -46,17 +46,17 @@ enum Square : int {
     NO_SQUARE
 };
 
-enum Color : int {
+enum Color : uint8_t {
     WHITE, BLACK, NO_COLOR
 };
 
-enum PieceType : int {
+enum PieceType : uint8_t {
     PAWN, KNIGHT, BISHOP,
     ROOK, QUEEN, KING,
     NO_PIECE_TYPE
 };
 
-enum Piece : int {
+enum Piece : uint8_t {
     W_PAWN, W_KNIGHT, W_BISHOP, W_ROOK, W_QUEEN, W_KING,
     B_PAWN, B_KNIGHT, B_BISHOP, B_ROOK, B_QUEEN, B_KING,
     NO_PIECE
@@ -83,7 +83,21 @@ enum StepType : int {
 enum class MoveGenType : int {
     QUIET,
     CAPTURE,
-    PSEUDOLEGAL
+    PSEUDOLEGAL,
+    LEGAL,
+    EVASIONS,     // legal moves out of check (only valid when in check)
+    QUIET_CHECKS  // pseudolegal non-capture, non-promote moves giving direct or discovered check (no castles)
+};
+
+// what a move does to the board (see Board::make_move)
+enum class MoveKind : int {
+    QUIET,
+    DOUBLE_PAWN_PUSH,
+    CASTLE,
+    CAPTURE,
+    ENPASSANT,
+    PROMOTE,
+    PROMOTE_CAPTURE
 };
 
 enum class NodeType : uint8_t {
@@ -93,15 +107,6 @@ enum class NodeType : uint8_t {
     CUT_NODE
 };
 
-struct StateInfo {
-    Key         zobrist_key;
-    std::size_t ply_clock;
-    Square      enpassant_square;
-    Castle      castling_rights;
-
-    Piece       piece_captured;
-};
-
 } // Types namespace
 
 
@@ -151,8 +156,11 @@ inline constexpr std::size_t RANK_SIZE         =    8;
 inline constexpr std::size_t FILE_SIZE         =    8;
 
 inline constexpr std::size_t MAX_PLY           = 1024;
+inline constexpr std::size_t MAX_SEARCH_PLY    =  128;
 
-inline constexpr std::size_t NUM_KILLER_MOVES  =    3;
+inline constexpr std::size_t CACHE_LINE_SIZE   =   64;
+
+inline constexpr std::size_t NUM_KILLER_MOVES  =    2;
 
 
 // eval constants
@@ -162,6 +170,9 @@ namespace Evals {
 inline constexpr Types::Eval INF  = 30000;
 inline constexpr Types::Eval MATE = 20000;
 
+// any score beyond this is a forced mate (within MAX_SEARCH_PLY plies)
+inline constexpr Types::Eval MATE_IN_MAX_PLY = MATE - static_cast<Types::Eval>(MAX_SEARCH_PLY);
+
 } // Eval namespace
 
 
@@ -10,25 +10,24 @@
 #include "movelist.hpp"   // pvline
 
 #include "tt.hpp"         // transpositiontable
+#include "matesearch.hpp" // matesolver
 #include "threads.hpp"    // enginethreadpool
+#include "abdada.hpp"     // abdada table
 
 #include <array>
+#include <string>         // string
+#include <vector>         // vector
 
 
 namespace MPChess {
 
-namespace Types {
-
-using HistoryTable = std::array<std::array<Types::MoveScore, Constants::NUM_SQUARES>, Constants::NUM_PIECES>;
-using KillerTable  = std::array<std::array<Move, Constants::NUM_KILLER_MOVES>, Constants::MAX_PLY>;
-
-} // Types namespace
-
 namespace Engine {
 
 struct EngineOptions {
-    std::size_t num_pvs     = 1;
-    std::size_t num_threads = 1;
+    std::size_t num_pvs      = 1;
+    std::size_t num_threads  = 1;
+    std::size_t hash_size_mb = Constants::DEFAULT_TABLE_SIZE_MB;
+    bool        abdada       = false; // threads divide work with ABDADA instead of lazy smp depth skipping
     
     // debug mode
 #ifndef NDEBUG
@@ -39,17 +38,24 @@ struct EngineOptions {
 
 };
 
-inline EngineOptions options;
+// last position command, the engine board is its fen with its moves played
+// (so the next command only has to play the moves it adds)
+struct PositionCommand {
+    std::string              fen;
+    std::vector<std::string> moves;
+};
+
+inline EngineOptions   options;
+inline PositionCommand position_command;
 inline SearchInfo    search_info;
 
-inline Types::HistoryTable history_table;
-inline Types::KillerTable  killer_table;
-inline TranspositionTable  tt(Constants::DEFAULT_TABLE_SIZE_MB);
+inline TranspositionTable tt(options.hash_size_mb);
+inline MateSolver         mate_solver(Constants::DEFAULT_MATE_TABLE_SIZE_MB);
 
 inline EngineThreadPool    thread_pool(options.num_threads);
+inline AbdadaTable         abdada_table;
 
 inline Board engine_board;
-inline std::vector<PVLine> pv_lines(options.num_pvs);
 
 inline Types::Milliseconds uci_update_frequency{1000};
 inline Types::TimePoint    prev_uci_update_time;
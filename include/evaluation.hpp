@@ -11,6 +11,7 @@ namespace MPChess {
 
 // Forward declarations
 class Board;
+class Move;
 
 namespace Constants {
 
@@ -114,4 +115,7 @@ Types::Eval evaluate_material(const Board& board);
 Types::Eval evaluate_piece_square(const Board& board);
 Types::Eval evaluate(const Board& board);
 
+// Static exchange evaluation
+Types::Eval static_exchange_evaluation(const Board& board, Move move);
+
 } // MPChess
\ No newline at end of file
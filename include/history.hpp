@@ -0,0 +1,92 @@
+// history.hpp
+
+#pragma once
+
+#include "defs.hpp"  // types, constants
+#include "move.hpp"  // move
+
+#include <array>     // array
+#include <algorithm> // min, fill
+#include <cstdlib>   // abs
+
+
+namespace MPChess {
+
+namespace Types {
+
+using HistoryScore = int16_t;
+
+using HistoryTable        = std::array<std::array<HistoryScore, Constants::NUM_SQUARES>, Constants::NUM_PIECES>; // [piece][to]
+using CounterMoveTable    = std::array<std::array<Move, Constants::NUM_SQUARES>, Constants::NUM_PIECES>;         // [prev piece][prev to]
+using ContinuationHistory = std::array<std::array<HistoryTable, Constants::NUM_SQUARES>, Constants::NUM_PIECES>; // [prev piece][prev to][piece][to]
+using CaptureHistory      = std::array<std::array<std::array<HistoryScore, Constants::NUM_PIECE_TYPES>,
+                                                  Constants::NUM_SQUARES>,
+                                       Constants::NUM_PIECES>;                                                    // [piece][to][captured piece type]
+
+} // Types namespace
+
+
+namespace Constants {
+
+// history scores are kept in [-MAX_HISTORY_SCORE, MAX_HISTORY_SCORE]
+// https://www.chessprogramming.org/History_Heuristic
+inline constexpr int MAX_HISTORY_SCORE = 16384;
+inline constexpr int MAX_HISTORY_BONUS = 1200;
+
+// continuation histories used for ordering (plies ago of the previous move)
+inline constexpr std::array<std::size_t, 2> CONTINUATION_PLIES = {1, 2};
+
+} // Constants namespace
+
+
+// history bonus/malus size for a cutoff at depth
+constexpr int history_bonus(Types::Depth depth) {
+    return std::min(32 * depth * depth, Constants::MAX_HISTORY_BONUS);
+}
+
+// "gravity" update
+//
+// the entry moves towards +/-MAX_HISTORY_SCORE by bonus, scaled down
+// the closer it already is, so entries never leave the bounds and
+// old information decays as new cutoffs come in
+constexpr void update_history(Types::HistoryScore& entry, int bonus) {
+    const int score = entry + bonus - entry * std::abs(bonus) / Constants::MAX_HISTORY_SCORE;
+    entry = static_cast<Types::HistoryScore>(score);
+}
+
+
+// per-thread move ordering heuristics
+
+struct HeuristicTables {
+
+    Types::HistoryTable        history;
+    Types::CounterMoveTable    counter_moves;
+    Types::ContinuationHistory continuation_history;
+    Types::CaptureHistory      capture_history;
+
+    void reset() {
+        for (auto& piece_row : this->history) {
+            piece_row.fill(0);
+        }
+
+        for (auto& piece_row : this->counter_moves) {
+            piece_row.fill(Move{});
+        }
+
+        for (auto& prev_piece_row : this->continuation_history) {
+            for (auto& prev_to_table : prev_piece_row) {
+                for (auto& piece_row : prev_to_table) {
+                    piece_row.fill(0);
+                }
+            }
+        }
+
+        for (auto& piece_row : this->capture_history) {
+            for (auto& to_row : piece_row) {
+                to_row.fill(0);
+            }
+        }
+    }
+};
+
+} // MPChess namespace
\ No newline at end of file
@@ -0,0 +1,161 @@
+// magics.hpp
+// generated by tools/magic_generator, do not edit
+// https://www.chessprogramming.org/Magic_Bitboards
+
+#pragma once
+
+#include "defs.hpp" // types, constants
+
+#include <array>    // array
+
+
+namespace MPChess {
+
+namespace Attacks {
+
+// magic number and key shift of a slider on one square
+// key = ((occupancy & blockers mask) * magic) >> key_shift
+struct MagicNumber {
+    uint64_t    magic;
+    std::size_t key_shift;
+};
+
+using MagicNumbers = std::array<MagicNumber, Constants::NUM_SQUARES>;
+
+inline constexpr MagicNumbers BISHOP_MAGIC_NUMBERS = {{
+    {0x0041020809090010ull, 58}, // a1
+    {0x20080b1414224192ull, 59}, // b1
+    {0x4014110409004010ull, 59}, // c1
+    {0x0084052200400000ull, 59}, // d1
+    {0x0202021000010142ull, 59}, // e1
+    {0x0001101804001110ull, 59}, // f1
+    {0x00a1110820241000ull, 59}, // g1
+    {0x2041004202201240ull, 58}, // h1
+    {0x0020902182108200ull, 59}, // a2
+    {0x0008020802440441ull, 59}, // b2
+    {0x1482108400414000ull, 59}, // c2
+    {0x000504041180c001ull, 59}, // d2
+    {0x0080940420300000ull, 59}, // e2
+    {0x9402491016300000ull, 59}, // f2
+    {0x0500050182104021ull, 59}, // g2
+    {0x0004020244122808ull, 59}, // h2
+    {0x0810014003980108ull, 59}, // a3
+    {0x2049200210140084ull, 59}, // b3
+    {0x08100020c5026020ull, 57}, // c3
+    {0x0028028088210100ull, 57}, // d3
+    {0x1608100501400500ull, 57}, // e3
+    {0x1009002200a18400ull, 57}, // f3
+    {0x0400401208044408ull, 59}, // g3
+    {0x0008250880841050ull, 59}, // h3
+    {0x8020090024304480ull, 59}, // a4
+    {0x00112012106c0120ull, 59}, // b4
+    {0x4001404108120040ull, 57}, // c4
+    {0xe80108000c004010ull, 55}, // d4
+    {0x0030101041004000ull, 55}, // e4
+    {0x0040ea0001018200ull, 57}, // f4
+    {0xa040840000840420ull, 59}, // g4
+    {0x0801030000404828ull, 59}, // h4
+    {0x08090410004010b1ull, 59}, // a5
+    {0x0042500480260800ull, 59}, // b5
+    {0x00840402000b0200ull, 57}, // c5
+    {0x2004200800010051ull, 55}, // d5
+    {0x0200420020020080ull, 55}, // e5
+    {0x0402900100888482ull, 57}, // f5
+    {0x00c2009400010c00ull, 59}, // g5
+    {0x0008090040410040ull, 59}, // h5
+    {0x05080422a0000800ull, 59}, // a6
+    {0x8902021a3e502000ull, 59}, // b6
+    {0x0a00140201000802ull, 57}, // c6
+    {0x1110004010400201ull, 57}, // d6
+    {0x8800210122020400ull, 57}, // e6
+    {0x00080a0802004058ull, 57}, // f6
+    {0x8020440282200092ull, 59}, // g6
+    {0x80010e2200404210ull, 59}, // h6
+    {0x04a4020805240101ull, 59}, // a7
+    {0x4101034210240000ull, 59}, // b7
+    {0x0001108400880004ull, 59}, // c7
+    {0x00a3080094040804ull, 59}, // d7
+    {0x01141020a4240c40ull, 59}, // e7
+    {0x00020c8810110008ull, 59}, // f7
+    {0x0018200480820000ull, 59}, // g7
+    {0x06b0822811032024ull, 59}, // h7
+    {0x000a0104010406c0ull, 58}, // a8
+    {0x000200a908061003ull, 59}, // b8
+    {0x4005100200840440ull, 59}, // c8
+    {0x009ac00000420200ull, 59}, // d8
+    {0x0450001054104404ull, 59}, // e8
+    {0x009600d420040108ull, 59}, // f8
+    {0x0004400808093040ull, 59}, // g8
+    {0x842c3f0405120a00ull, 58}, // h8
+}};
+
+inline constexpr MagicNumbers ROOK_MAGIC_NUMBERS = {{
+    {0x0c80004000211080ull, 52}, // a1
+    {0x9100210080400012ull, 53}, // b1
+    {0x4200083020408200ull, 53}, // c1
+    {0x0100201000982500ull, 53}, // d1
+    {0x01800aa800804400ull, 53}, // e1
+    {0x0a00090402001810ull, 53}, // f1
+    {0x8400009011020408ull, 53}, // g1
+    {0x5200004828840601ull, 52}, // h1
+    {0x000080003e400080ull, 53}, // a2
+    {0x000d004001002180ull, 54}, // b2
+    {0x3402001060820440ull, 54}, // c2
+    {0x0000801000800801ull, 54}, // d2
+    {0x0c0200240a003020ull, 54}, // e2
+    {0xc002000410080200ull, 54}, // f2
+    {0x0102000200e40108ull, 54}, // g2
+    {0x088500004200b100ull, 53}, // h2
+    {0x00008a800420400aull, 53}, // a3
+    {0x4010004000600040ull, 54}, // b3
+    {0x0080820026003040ull, 54}, // c3
+    {0x2084808008001001ull, 54}, // d3
+    {0x0002808004000801ull, 54}, // e3
+    {0x0020808004000200ull, 54}, // f3
+    {0x0080808002000100ull, 54}, // g3
+    {0x2020020001019044ull, 53}, // h3
+    {0x1180004540002002ull, 53}, // a4
+    {0x0033400100208108ull, 54}, // b4
+    {0x2981401500200104ull, 54}, // c4
+    {0x4890900080800800ull, 54}, // d4
+    {0x00000d0100280030ull, 54}, // e4
+    {0x0002004200288490ull, 54}, // f4
+    {0x1012000200010ce8ull, 54}, // g4
+    {0x8089002300008042ull, 53}, // h4
+    {0x0002804000800030ull, 53}, // a5
+    {0x820aa00684804000ull, 54}, // b5
+    {0x9441003041002000ull, 54}, // c5
+    {0x0000290021001001ull, 54}, // d5
+    {0x100100080100100cull, 54}, // e5
+    {0x0000204008011004ull, 54}, // f5
+    {0x0021082104000230ull, 54}, // g5
+    {0x0000149c02002041ull, 53}, // h5
+    {0x0008609240028000ull, 53}, // a6
+    {0x0090024020004000ull, 54}, // b6
+    {0x0904100020008080ull, 54}, // c6
+    {0x0a020012400a0020ull, 54}, // d6
+    {0x0028001500490010ull, 54}, // e6
+    {0x0001006400490002ull, 54}, // f6
+    {0x0201120004010100ull, 54}, // g6
+    {0x00c1b86400820001ull, 53}, // h6
+    {0x4320800240106080ull, 53}, // a7
+    {0x0502044308208200ull, 54}, // b7
+    {0x0421801020420200ull, 54}, // c7
+    {0x3408080080100680ull, 54}, // d7
+    {0x0022880004008080ull, 54}, // e7
+    {0x6002000814901600ull, 54}, // f7
+    {0x0405001a000c0100ull, 54}, // g7
+    {0x20204400cd00a200ull, 53}, // h7
+    {0x0380c0800020f101ull, 52}, // a8
+    {0x0400610040028011ull, 53}, // b8
+    {0x0002421108802202ull, 53}, // c8
+    {0x1000100100182005ull, 53}, // d8
+    {0x1002006128101402ull, 53}, // e8
+    {0x0001000c00021801ull, 53}, // f8
+    {0x4000190810520094ull, 53}, // g8
+    {0x1000022104184082ull, 52}, // h8
+}};
+
+} // Attacks namespace
+
+} // MPChess namespace
\ No newline at end of file
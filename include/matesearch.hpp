@@ -0,0 +1,124 @@
+// matesearch.hpp
+// depth limited df-pn (depth-first proof-number search) mate solver
+// https://www.chessprogramming.org/Proof-Number_Search
+// https://www.chessprogramming.org/DFPN_Search
+
+#pragma once
+
+#include "defs.hpp"     // types, constants
+#include "move.hpp"     // move
+#include "movelist.hpp" // movelist
+#include "board.hpp"    // board
+
+#include <array>        // array
+#include <vector>       // vector
+#include <limits>       // max value
+#include <string>       // string
+#include <functional>   // function
+
+
+namespace MPChess {
+
+namespace Constants {
+
+inline constexpr std::size_t DEFAULT_MATE_TABLE_SIZE_MB = 16;
+inline constexpr std::size_t MATE_TABLE_BUCKET_SIZE     =  4;
+
+// proof/disproof numbers saturate at PROOF_INF (solved)
+inline constexpr uint32_t PROOF_INF = std::numeric_limits<uint32_t>::max() / 2;
+
+// stop callback is polled every MATE_STOP_CHECK_NODES nodes
+inline constexpr uint64_t MATE_STOP_CHECK_NODES = 4096;
+
+} // Constants namespace
+
+
+namespace Types {
+
+// phi/delta are from the perspective of the side to move at the node
+//   phi   == 0 : side to move wins (attacker mates, or defender escapes)
+//   delta == 0 : side to move loses
+// i.e. phi is the proof number at attacker nodes and the disproof number at defender nodes
+struct MateEntry {
+    Key      key;   // 8 bytes (zobrist key mixed with remaining plies)
+    uint32_t phi;   // 4 bytes
+    uint32_t delta; // 4 bytes
+};
+
+using MateBucket = std::array<MateEntry, Constants::MATE_TABLE_BUCKET_SIZE>;
+
+} // Types namespace
+
+
+// bounded hash table for the mate solver
+// separate from the search tt, entries are only valid for an exact number of remaining plies
+
+class MateTable {
+private:
+
+    std::size_t                    table_size; // number of buckets
+    std::vector<Types::MateBucket> table;
+
+public:
+
+    // constructors
+    MateTable(std::size_t table_size_mb = Constants::DEFAULT_MATE_TABLE_SIZE_MB);
+
+
+    // resize table
+    void resize(std::size_t size_mb);
+
+    // reset
+    void reset();
+
+    // store/probe
+    bool probe(Types::Key key, uint32_t& phi, uint32_t& delta) const;
+    void store(Types::Key key, uint32_t phi, uint32_t delta);
+};
+
+
+struct MateResult {
+    bool            proven    = false; // forced mate found
+    bool            stopped   = false; // stopped before the search finished
+    std::size_t     mate_in_n = 0;     // moves until mate (if proven)
+    RegularMoveList pv;                // mating line (may be cut short, even empty, by table replacements)
+    uint64_t        nodes     = 0;
+};
+
+
+class MateSolver {
+private:
+
+    MateTable             table;
+    std::function<bool()> should_stop;
+
+    uint64_t nodes   = 0;
+    bool     stopped = false;
+
+    // multiple iterative deepening/threshold loop (df-pn "MID")
+    void mid(Board& board, std::size_t remaining, uint32_t th_phi, uint32_t th_delta);
+
+    void extract_pv(Board& board, std::size_t remaining, RegularMoveList& pv);
+
+public:
+
+    // constructors
+    MateSolver(std::size_t table_size_mb = Constants::DEFAULT_MATE_TABLE_SIZE_MB);
+
+
+    // table
+    MateTable& get_table();
+
+    // solve
+    // tries mate in 1, 2, ..., max_moves and returns the shortest mate found
+    MateResult solve(Board& board, std::size_t max_moves, std::function<bool()> should_stop = {});
+};
+
+
+// batch mode
+// solves every EPD position with a "dm N" (direct mate) operation, positions are split over num_threads
+// each thread has its own solver and a table of table_size_mb / num_threads
+
+void mate_batch(const std::string& epd_path, std::size_t num_threads, std::size_t table_size_mb);
+
+} // MPChess namespace
\ No newline at end of file
@@ -8,14 +8,164 @@
 #include "board.hpp"    // board
 #include "movelist.hpp" // movelist
 
-#include "attacks.hpp"  // attacks
+#include "attacks.hpp"  // attacks, inbetween squares, lines
+
+#include <array>        // array
 
 
 namespace MPChess {
 
+namespace Types {
+
+// move generation masks, computed once per node
+// moves are only generated to allowed squares
+struct MoveGenMasks {
+
+    // legal/evasion generation (no make/unmake is needed to reject illegal moves)
+    Bitboard checkers;                                     // enemy pieces giving check
+    Bitboard pinned;                                       // friendly pieces pinned to the king
+    Bitboard king_danger;                                  // squares attacked by the enemy (sliders x-ray through the king)
+    Bitboard target;                                       // allowed to squares for non-king moves (block/capture squares if in check)
+    std::array<Bitboard, Constants::NUM_SQUARES> pin_rays; // allowed to squares of a pinned piece (only set for pinned squares)
+
+    // quiet check generation
+    CheckInfo check_info;
+};
+
+} // Types namespace
+
+
+template<Types::Color color_friend>
+requires (color_friend != Types::Color::NO_COLOR)
+Types::MoveGenMasks generate_legal_masks(const Board& board) {
+
+    Types::MoveGenMasks masks;
+
+    const Types::Color    color_enemy = ~color_friend;
+    const Types::Square   king        = board.get_king_square<color_friend>();
+    const Types::Bitboard friendly    = board.get_occupation_bb(color_friend);
+    const Types::Bitboard enemy       = board.get_occupation_bb(color_enemy);
+    const Types::Bitboard occupied    = ~board.get_occupation_bb(Types::Color::NO_COLOR);
+
+    const Types::Bitboard enemy_diagonal = board.get_piece_bb(color_enemy, Types::PieceType::BISHOP) | board.get_piece_bb(color_enemy, Types::PieceType::QUEEN);
+    const Types::Bitboard enemy_straight = board.get_piece_bb(color_enemy, Types::PieceType::ROOK)   | board.get_piece_bb(color_enemy, Types::PieceType::QUEEN);
+
+    // checkers
+    masks.checkers = board.attacks_to(king) & enemy;
+
+    // pins
+    // enemy sliders that see the king through friendly pieces only (snipers),
+    // pinned if exactly one friendly piece is inbetween
+    masks.pinned = Constants::EMPTY;
+
+    Types::Bitboard snipers = (Attacks::attacks<Types::PieceType::BISHOP>(king, enemy) & enemy_diagonal)
+                            | (Attacks::attacks<Types::PieceType::ROOK>(king, enemy)   & enemy_straight);
+    while (snipers) {
+        const Types::Square   sniper   = pop_lsb(snipers);
+        const Types::Bitboard blockers = Attacks::inbetween_squares(king, sniper) & occupied;
+
+        if (pop_count(blockers) == 1 && (blockers & friendly)) {
+            masks.pinned |= blockers;
+            masks.pin_rays[bitboard_to_square(blockers)] = Attacks::inbetween_squares(king, sniper) | sniper;
+        }
+    }
+
+    // king danger squares
+    // king is removed from occupancy so it can not step backwards along a slider check
+    const Types::Bitboard occupied_no_king = occupied & ~square_to_bitboard(king);
+
+    masks.king_danger = Attacks::attacks<Types::PieceType::PAWN, color_enemy>(board.get_piece_bb(color_enemy, Types::PieceType::PAWN))
+                      | Attacks::attacks<Types::PieceType::KNIGHT>(board.get_piece_bb(color_enemy, Types::PieceType::KNIGHT))
+                      | Attacks::attacks<Types::PieceType::KING>(board.get_piece_bb(color_enemy, Types::PieceType::KING))
+                      | Attacks::attacks<Types::PieceType::BISHOP>(enemy_diagonal, occupied_no_king)
+                      | Attacks::attacks<Types::PieceType::ROOK>(enemy_straight, occupied_no_king);
+
+    // evasion target squares
+    // no check: anywhere, single check: capture checker or block, double check: king moves only
+    const int num_checkers = pop_count(masks.checkers);
+    if      (num_checkers == 0) {masks.target = Constants::UNIVERSE;}
+    else if (num_checkers == 1) {masks.target = Attacks::inbetween_squares(king, bitboard_to_square(masks.checkers)) | masks.checkers;}
+    else                        {masks.target = Constants::EMPTY;}
+
+    return masks;
+}
+
+
+// legal generation types (moves are filtered by the legal masks)
+constexpr bool is_legal_gen_type(Types::MoveGenType gen_type) {
+    return gen_type == Types::MoveGenType::LEGAL
+        || gen_type == Types::MoveGenType::EVASIONS;
+}
+
+// generation types with captures (including promote captures and enpassants)
+constexpr bool has_captures(Types::MoveGenType gen_type) {
+    return gen_type != Types::MoveGenType::QUIET
+        && gen_type != Types::MoveGenType::QUIET_CHECKS;
+}
+
+// generation types with promote pushes
+constexpr bool has_promote_pushes(Types::MoveGenType gen_type) {
+    return gen_type != Types::MoveGenType::QUIET
+        && gen_type != Types::MoveGenType::CAPTURE
+        && gen_type != Types::MoveGenType::QUIET_CHECKS;
+}
+
+// generation types with castles (never possible in check)
+constexpr bool has_castles(Types::MoveGenType gen_type) {
+    return gen_type != Types::MoveGenType::CAPTURE
+        && gen_type != Types::MoveGenType::EVASIONS
+        && gen_type != Types::MoveGenType::QUIET_CHECKS;
+}
+
+
+// allowed to squares of a piece (everything for pseudolegal generation)
+template<Types::MoveGenType gen_type, Types::PieceType piece_type>
+constexpr Types::Bitboard allowed_to_squares(const Types::MoveGenMasks* p_masks, Types::Square from) {
+    if constexpr (is_legal_gen_type(gen_type)) {
+        if constexpr (piece_type == Types::PieceType::KING) {
+            return ~p_masks->king_danger;
+        }
+        return (p_masks->pinned & from) ? (p_masks->target & p_masks->pin_rays[from])
+                                        :  p_masks->target;
+    }
+    else if constexpr (gen_type == Types::MoveGenType::QUIET_CHECKS) {
+        const Types::CheckInfo& check_info = p_masks->check_info;
+        return (check_info.discover_candidates & from) ? (~Attacks::line_through(check_info.enemy_king, from) | check_info.check_squares[piece_type])
+                                                       :   check_info.check_squares[piece_type];
+    }
+    else {
+        return Constants::UNIVERSE;
+    }
+}
+
+
+// enpassant removes two pieces from the same rank, which pin masks can not see
+// so check the king directly against enemy sliders with the updated occupancy
+template<Types::Color color_friend>
+requires (color_friend != Types::Color::NO_COLOR)
+bool is_legal_enpassant(const Board& board, const Types::MoveGenMasks& masks, Types::Square from, Types::Square to) {
+
+    const Types::Color    color_enemy = ~color_friend;
+    const Types::StepType backward    = (color_friend == Types::Color::WHITE) ? Types::StepType::S : Types::StepType::N;
+    const Types::Square   captured    = step<backward>(to);
+
+    // must capture the checker or block the check
+    if (!((to | captured) & masks.target)) {return false;}
+
+    const Types::Square   king      = board.get_king_square<color_friend>();
+    const Types::Bitboard occupancy = (~board.get_occupation_bb(Types::Color::NO_COLOR) & ~(from | captured)) | to;
+
+    const Types::Bitboard enemy_diagonal = board.get_piece_bb(color_enemy, Types::PieceType::BISHOP) | board.get_piece_bb(color_enemy, Types::PieceType::QUEEN);
+    const Types::Bitboard enemy_straight = board.get_piece_bb(color_enemy, Types::PieceType::ROOK)   | board.get_piece_bb(color_enemy, Types::PieceType::QUEEN);
+
+    return is_empty(Attacks::attacks<Types::PieceType::BISHOP>(king, occupancy) & enemy_diagonal)
+        && is_empty(Attacks::attacks<Types::PieceType::ROOK>(king, occupancy)   & enemy_straight);
+}
+
+
 template<Types::MoveGenType gen_type, Types::Color color_friend, Concepts::move_like move_t=Move>
 requires (color_friend != Types::Color::NO_COLOR)
-std::size_t generate_pawn_moves(const Board& board, MoveList<move_t>& move_list) {
+std::size_t generate_pawn_moves(const Board& board, MoveList<move_t>& move_list, const Types::MoveGenMasks* p_masks=nullptr) {
 
     std::size_t initial_list_size = move_list.get_size();
 
@@ -34,7 +184,7 @@ std::size_t generate_pawn_moves(const Board& board, MoveList<move_t>& move_list)
 
     
     // capture moves: diagonal captures, enpassants, and promote captures
-    if constexpr (gen_type != Types::MoveGenType::QUIET) {
+    if constexpr (has_captures(gen_type)) {
 
         // get pawns
         Types::Bitboard pawns = board.get_piece_bb(color_friend, Types::PieceType::PAWN);
@@ -45,9 +195,9 @@ std::size_t generate_pawn_moves(const Board& board, MoveList<move_t>& move_list)
             // get square of current pawn
             const Types::Square from = pop_lsb(pawns);
 
-            // get all pawn captures
+            // get all pawn captures (enpassant legality is checked separately)
             Types::Bitboard captures = Attacks::attacks<Types::PieceType::PAWN, color_friend>(from)
-                                     & (enemy | enpassant_sq);
+                                     & ((enemy & allowed_to_squares<gen_type, Types::PieceType::PAWN>(p_masks, from)) | enpassant_sq);
 
             // loop over captures
             while (captures) {
@@ -56,6 +206,9 @@ std::size_t generate_pawn_moves(const Board& board, MoveList<move_t>& move_list)
 
                 // add enpassant capture
                 if (to == enpassant_sq) {
+                    if constexpr (is_legal_gen_type(gen_type)) {
+                        if (!is_legal_enpassant<color_friend>(board, *p_masks, from, to)) {continue;}
+                    }
                     move_list.add_move(move_t(from, to, Constants::Move::Flags::ENPASSANT));
                 }
 
@@ -89,17 +242,19 @@ std::size_t generate_pawn_moves(const Board& board, MoveList<move_t>& move_list)
         while (pawns) {
 
             // get square of current pawn
-            const Types::Square from  = pop_lsb(pawns);
-            const Types::Square front = step<forward>(from);
+            const Types::Square   from  = pop_lsb(pawns);
+            const Types::Square   front = step<forward>(from);
+            const Types::Bitboard legal = allowed_to_squares<gen_type, Types::PieceType::PAWN>(p_masks, from);
 
             // add single pawn push
             if (front & unoccupied) {
-                move_list.add_move(move_t(from, front, Constants::Move::Flags::QUIET));
-            
+                if (front & legal) {
+                    move_list.add_move(move_t(from, front, Constants::Move::Flags::QUIET));
+                }
 
                 // add double pawn push
                 const Types::Square front_front = step<forward>(front);
-                if ((from & second_rank) && (front_front & unoccupied)) {
+                if ((from & second_rank) && (front_front & unoccupied & legal)) {
                     move_list.add_move(move_t(from, front_front, Constants::Move::Flags::DOUBLE_PAWN_PUSH));
                 }
             }
@@ -107,9 +262,7 @@ std::size_t generate_pawn_moves(const Board& board, MoveList<move_t>& move_list)
     }
 
     // non-quiet and non-capture moves: promote pawn push
-    if constexpr (gen_type != Types::MoveGenType::QUIET &&
-                  gen_type != Types::MoveGenType::CAPTURE)
-    {
+    if constexpr (has_promote_pushes(gen_type)) {
 
         // get pawns
         Types::Bitboard seventh_rank_pawns = board.get_piece_bb(color_friend, Types::PieceType::PAWN)
@@ -123,7 +276,7 @@ std::size_t generate_pawn_moves(const Board& board, MoveList<move_t>& move_list)
             const Types::Square to   = step<forward>(from);
 
             // add promote push
-            if (to & unoccupied) {
+            if (to & unoccupied & allowed_to_squares<gen_type, Types::PieceType::PAWN>(p_masks, from)) {
                 for (const Types::MoveFlag promote_flag : {Constants::Move::Flags::PROMOTE_KNIGHT_QUIET,
                                                            Constants::Move::Flags::PROMOTE_BISHOP_QUIET,
                                                            Constants::Move::Flags::PROMOTE_ROOK_QUIET,
@@ -142,7 +295,7 @@ std::size_t generate_pawn_moves(const Board& board, MoveList<move_t>& move_list)
 
 template<Types::MoveGenType gen_type, Types::Color color_friend, Concepts::move_like move_t=Move>
 requires (color_friend != Types::Color::NO_COLOR)
-std::size_t generate_king_moves(const Board& board, MoveList<move_t>& move_list) {
+std::size_t generate_king_moves(const Board& board, MoveList<move_t>& move_list, const Types::MoveGenMasks* p_masks=nullptr) {
 
     std::size_t initial_list_size = move_list.get_size();
 
@@ -151,7 +304,8 @@ std::size_t generate_king_moves(const Board& board, MoveList<move_t>& move_list)
 
     const Types::Square   from        = bitboard_to_square(board.get_piece_bb(color_friend, Types::PieceType::KING));
 
-    const Types::Bitboard king_moves  = Attacks::attacks<Types::PieceType::KING>(from);
+    const Types::Bitboard king_moves  = Attacks::attacks<Types::PieceType::KING>(from)
+                                      & allowed_to_squares<gen_type, Types::PieceType::KING>(p_masks, from);
 
     const Types::Color    color_enemy = ~color_friend;
     const Types::Bitboard enemy       =  board.get_occupation_bb(color_enemy)
@@ -161,7 +315,7 @@ std::size_t generate_king_moves(const Board& board, MoveList<move_t>& move_list)
 
 
     // capture moves
-    if constexpr (gen_type != Types::MoveGenType::QUIET) {
+    if constexpr (has_captures(gen_type)) {
 
         // get captures
         Types::Bitboard captures = king_moves & enemy;
@@ -191,10 +345,12 @@ std::size_t generate_king_moves(const Board& board, MoveList<move_t>& move_list)
     }
 
     // castle moves
-    if constexpr (gen_type != Types::MoveGenType::CAPTURE) {
+    if constexpr (has_castles(gen_type)) {
 
         // check for existing castle rights and check
-        const bool check = board.is_check<true>();
+        bool check;
+        if constexpr (is_legal_gen_type(gen_type)) {check = !is_empty(p_masks->checkers);}
+        else                                                 {check = board.is_check<true>();}
         const Types::Castle castle_rights = static_cast<Types::Castle>(board.get_castling_rights() & color_castle_mask);
 
         if (!check && castle_rights) {
@@ -218,6 +374,11 @@ std::size_t generate_king_moves(const Board& board, MoveList<move_t>& move_list)
                     const bool safe_king_path       = is_empty(board.attacks_to(king_castle_path) & enemy);
                     const bool empty_castle_squares = is_empty(castle_squares & occupied);
 
+                    // legal generation also checks the destination square
+                    if constexpr (is_legal_gen_type(gen_type)) {
+                        if (king_to & p_masks->king_danger) {continue;}
+                    }
+
                     // add castle move
                     if (safe_king_path && empty_castle_squares) {
                         move_list.add_move(move_t(king_from, king_to, castle_flag));
@@ -235,17 +396,17 @@ std::size_t generate_king_moves(const Board& board, MoveList<move_t>& move_list)
 template<Types::MoveGenType gen_type, Types::Color color_friend, Types::PieceType piece_type, Concepts::move_like move_t=Move>
 requires (piece_type   != Types::PieceType::NO_PIECE_TYPE) &&
          (color_friend != Types::Color::NO_COLOR)
-std::size_t generate_piece_moves(const Board& board, MoveList<move_t>& move_list) {
+std::size_t generate_piece_moves(const Board& board, MoveList<move_t>& move_list, const Types::MoveGenMasks* p_masks=nullptr) {
 
     std::size_t initial_list_size = move_list.get_size();
 
     if      constexpr (piece_type == Types::PieceType::PAWN) {
-        std::size_t num_pseudo_legal_generated = generate_pawn_moves<gen_type, color_friend>(board, move_list);
+        std::size_t num_pseudo_legal_generated = generate_pawn_moves<gen_type, color_friend>(board, move_list, p_masks);
         return num_pseudo_legal_generated;
     }
 
     else if constexpr (piece_type == Types::PieceType::KING) {
-        std::size_t num_pseudo_legal_generated = generate_king_moves<gen_type, color_friend>(board, move_list);
+        std::size_t num_pseudo_legal_generated = generate_king_moves<gen_type, color_friend>(board, move_list, p_masks);
         return num_pseudo_legal_generated;
     }
 
@@ -269,11 +430,12 @@ std::size_t generate_piece_moves(const Board& board, MoveList<move_t>& move_list
             const Types::Square from = pop_lsb(pieces);
 
             // get all possible to squares of current piece
-            const Types::Bitboard all_to_sqs = Attacks::attacks<piece_type>(from, occupied);
+            const Types::Bitboard all_to_sqs = Attacks::attacks<piece_type>(from, occupied)
+                                             & allowed_to_squares<gen_type, piece_type>(p_masks, from);
 
 
             // capture moves
-            if constexpr (gen_type != Types::MoveGenType::QUIET) {
+            if constexpr (has_captures(gen_type)) {
                 
                 // add captures
                 Types::Bitboard capture_to_sqs = all_to_sqs & enemy;
@@ -309,6 +471,42 @@ std::size_t generate_moves(const Board& board, MoveList<move_t>& move_list) {
 
     std::size_t move_count = 0;
 
+    // legal moves and evasions
+    if constexpr (is_legal_gen_type(gen_type)) {
+        const Types::MoveGenMasks masks = generate_legal_masks<color_friend>(board);
+
+        // evasions
+        // double check, only the king can move
+        if (pop_count(masks.checkers) > 1) {
+            return generate_king_moves<gen_type, color_friend>(board, move_list, &masks);
+        }
+
+        // single check, moves are restricted to masks.target (capture checker/block) or king moves
+        move_count += generate_pawn_moves<gen_type, color_friend>(board, move_list, &masks);
+        move_count += generate_king_moves<gen_type, color_friend>(board, move_list, &masks);
+        move_count += generate_piece_moves<gen_type, color_friend, Types::PieceType::KNIGHT>(board, move_list, &masks);
+        move_count += generate_piece_moves<gen_type, color_friend, Types::PieceType::BISHOP>(board, move_list, &masks);
+        move_count += generate_piece_moves<gen_type, color_friend, Types::PieceType::ROOK>(board, move_list, &masks);
+        move_count += generate_piece_moves<gen_type, color_friend, Types::PieceType::QUEEN>(board, move_list, &masks);
+
+        return move_count;
+    }
+
+    // quiet checks
+    if constexpr (gen_type == Types::MoveGenType::QUIET_CHECKS) {
+        Types::MoveGenMasks masks;
+        masks.check_info = board.get_check_info();
+
+        move_count += generate_pawn_moves<gen_type, color_friend>(board, move_list, &masks);
+        move_count += generate_king_moves<gen_type, color_friend>(board, move_list, &masks);
+        move_count += generate_piece_moves<gen_type, color_friend, Types::PieceType::KNIGHT>(board, move_list, &masks);
+        move_count += generate_piece_moves<gen_type, color_friend, Types::PieceType::BISHOP>(board, move_list, &masks);
+        move_count += generate_piece_moves<gen_type, color_friend, Types::PieceType::ROOK>(board, move_list, &masks);
+        move_count += generate_piece_moves<gen_type, color_friend, Types::PieceType::QUEEN>(board, move_list, &masks);
+
+        return move_count;
+    }
+
     move_count += generate_pawn_moves<gen_type, color_friend>(board, move_list);
     move_count += generate_king_moves<gen_type, color_friend>(board, move_list);
     move_count += generate_piece_moves<gen_type, color_friend, Types::PieceType::KNIGHT>(board, move_list);
@@ -8,7 +8,11 @@
 #include "movelist.hpp" // movelist
 #include "board.hpp"    // board
 #include "movegen.hpp"  // movegen
-#include "engine.hpp"   // engine tables (tt, killer, history)
+#include "engine.hpp"   // engine tables (tt)
+#include "history.hpp"  // history tables
+#include "searchstack.hpp" // killer moves
+
+#include "evaluation.hpp" // piece scores, static exchange evaluation
 
 #include <array>  // array
 #include <limits> // max value
@@ -19,63 +23,46 @@ namespace MPChess {
 
 namespace Constants {
 
-    inline constexpr std::array<std::array<Types::MoveScore, NUM_PIECE_TYPES>, NUM_PIECE_TYPES> MVVLVA_SCORES = []() consteval {
-        std::array<std::array<Types::MoveScore, NUM_PIECE_TYPES>, NUM_PIECE_TYPES> mmvlva_scores;
-        std::array<Types::MoveScore, NUM_PIECES> victim_scores = {1,2,3,4,5,6};
-
-        for (const Types::PieceType& victim : ALL_PIECE_TYPES) {
-            for (const Types::PieceType& attacker : ALL_PIECE_TYPES) {
-                mmvlva_scores[victim][attacker] = ((victim_scores[victim] + NUM_PIECE_TYPES) - victim_scores[attacker]);
-            }
-        }
-
-        return mmvlva_scores;
-    }();
-
-    inline constexpr Types::MoveScore MIN_MVVLVA_SCORE  = []() consteval {
-        Types::MoveScore min_score = std::numeric_limits<Types::MoveScore>::max();
-        for (const auto& row : MVVLVA_SCORES) {
-            for (const auto& score : row) {
-                min_score = std::min(min_score, score);
-            }
-        }
-
-        return min_score;
-    }();
+    // captures are scored as MVV (most valuable victim) + capture history
+    // capture score is in [0, CAPTURE_SCORE_RANGE]
+    inline constexpr Types::MoveScore MVV_SCORE_SCALE     = 16;
+    inline constexpr Types::MoveScore CAPTURE_SCORE_RANGE = MVV_SCORE_SCALE * QUEEN_SCORE + 2 * MAX_HISTORY_SCORE;
 
-    inline constexpr Types::MoveScore MAX_MVVLVA_SCORE  = []() consteval {
-        Types::MoveScore max_score = std::numeric_limits<Types::MoveScore>::min();
-        for (const auto& row : MVVLVA_SCORES) {
-            for (const auto& score : row) {
-                max_score = std::max(max_score, score);
-            }
-        }
-
-        return max_score;
-    }();
+    // quiet history sum is in [-N * MAX_HISTORY_SCORE, N * MAX_HISTORY_SCORE]
+    // for N = butterfly history + continuation histories
+    inline constexpr Types::MoveScore QUIET_HISTORY_RANGE = (1 + CONTINUATION_PLIES.size()) * MAX_HISTORY_SCORE;
 
-
-    inline constexpr Types::MoveScore TT_MOVE_SCORE        = std::numeric_limits<Types::MoveScore>::max();
-    inline constexpr Types::MoveScore CAPTURE_SCORE_OFFSET = TT_MOVE_SCORE - 1 - MAX_MVVLVA_SCORE;
-    inline constexpr Types::MoveScore KILLER_SCORE_OFFSET  = CAPTURE_SCORE_OFFSET + MIN_MVVLVA_SCORE - 1;
+    inline constexpr Types::MoveScore TT_MOVE_SCORE             = std::numeric_limits<Types::MoveScore>::max();
+    inline constexpr Types::MoveScore GOOD_CAPTURE_SCORE_OFFSET = TT_MOVE_SCORE - 1 - CAPTURE_SCORE_RANGE;
+    inline constexpr Types::MoveScore KILLER_SCORE_OFFSET       = GOOD_CAPTURE_SCORE_OFFSET - 1;
+    inline constexpr Types::MoveScore COUNTER_MOVE_SCORE        = KILLER_SCORE_OFFSET - NUM_KILLER_MOVES;
+    inline constexpr Types::MoveScore QUIET_SCORE_OFFSET        = CAPTURE_SCORE_RANGE + 1 + QUIET_HISTORY_RANGE;
+    inline constexpr Types::MoveScore BAD_CAPTURE_SCORE_OFFSET  = 0;
+    static_assert(QUIET_SCORE_OFFSET + QUIET_HISTORY_RANGE < COUNTER_MOVE_SCORE);
 
     /*
     //
-    // #    [movetype]         [movescore]
-    // 1)   tt move         => TT_MOVE_SCORE
-    // 2)   best capture    => TT_MOVE_SCORE - 1 = CAPTURE_SCORE_OFFSET + MAX_MVVLVA_SCORE
-    // 3)   capture
+    // #    [movetype]            [movescore]
+    // 1)   tt move            => TT_MOVE_SCORE
+    // 2)   best capture       => TT_MOVE_SCORE - 1 = GOOD_CAPTURE_SCORE_OFFSET + CAPTURE_SCORE_RANGE
+    // 3)   good capture
+    // ...
+    // X)   worst good capture => GOOD_CAPTURE_SCORE_OFFSET
+    // X+1) 1st killer move    => GOOD_CAPTURE_SCORE_OFFSET - 1 = KILLER_SCORE_OFFSET
+    // X+2) 2nd killer move    => KILLER_SCORE_OFFSET - 1
+    // Z)   counter move       => KILLER_SCORE_OFFSET - 2 = COUNTER_MOVE_SCORE
+    // Z+1) best quiet         => QUIET_SCORE_OFFSET + history sum
+    // ...
+    // W)   best bad capture   => BAD_CAPTURE_SCORE_OFFSET + CAPTURE_SCORE_RANGE
     // ...
-    // X)   worst capture   => CAPTURE_SCORE_OFFSET + MIN_MVVLVA_SCORE
-    // X+1) 1st killer move => CAPTURE_SCORE_OFFSET + MIN_MVVLVA_SCORE - 1 = KILLER_SCORE_OFFSET
-    // X+2) 2nd killer move => KILLER_SCORE_OFFSET
-    // X+Y) Yth killer move => KILLER_SCORE_OFFSET
     //
     // A) hash move(s) is(are) scored as max
-    // B) captures are scored as CAPTURE_SCORE_OFFSET + MVVLVA
-    // C) killers are scored as CAPTURE_SCORE_OFFSET + MIN_MVVLVA - 1 (i.e. scored to be immediately after worst capture)
-    // D) histories are scored as just the history score (starting at 0)
-    // TODO : verify all histories are below killers
+    // B) good captures (SEE >= 0) are scored as GOOD_CAPTURE_SCORE_OFFSET + MVV + capture history
+    // C) killers (of the current search ply) are scored immediately after worst good capture, newest killer first
+    // D) counter move (refutation of previous move) is scored directly below killers
+    // E) quiets are scored as QUIET_SCORE_OFFSET + history + 1-ply and 2-ply continuation histories
+    //    histories are bounded (gravity updates), so quiets always stay below counter moves
+    // F) bad captures (SEE < 0) are scored as BAD_CAPTURE_SCORE_OFFSET + MVV + capture history (i.e. below all quiets)
     //
     */
 
@@ -89,7 +76,9 @@ class MovePicker {
 
 private:
 
-    const Board& position;
+    const Board&           position;
+    const HeuristicTables&    heuristics;
+    const Types::KillerMoves& killers;
 
     std::size_t     iter = 0;
     OrderedMoveList move_list;
@@ -98,12 +87,28 @@ public:
 
     // Constructors
 
-    MovePicker(const Board& pos) : position{pos}
+    // in check, only (legal) evasions are generated for any gen_type
+    // quiet_checks adds quiet checking moves to capture generation (first quiescence ply)
+    MovePicker(const Board& pos, const HeuristicTables& heuristics, const Types::KillerMoves& killers, bool quiet_checks = false) :
+        position{pos},
+        heuristics{heuristics},
+        killers{killers}
     {
-        // Generate all pseudolegal moves
-        generate_moves<gen_type>(this->position, this->move_list);
+        // Generate moves
+        if (this->position.is_check<true>()) {
+            generate_moves<Types::MoveGenType::EVASIONS>(this->position, this->move_list);
+        }
+        else {
+            generate_moves<gen_type>(this->position, this->move_list);
 
-        // Score all pseudolegal moves
+            if constexpr (gen_type == Types::MoveGenType::CAPTURE) {
+                if (quiet_checks) {
+                    generate_moves<Types::MoveGenType::QUIET_CHECKS>(this->position, this->move_list);
+                }
+            }
+        }
+
+        // Score all moves
         // TODO : - promotions?
         //        - make sure no overlap using these manual offsets
 
@@ -111,6 +116,26 @@ public:
         const Types::TTEntry tt_entry = Engine::tt.probe(this->position.get_zobrist_key());
         const Move           tt_move  = tt_entry.move;
 
+        // Get counter move and continuation histories of previous moves
+        Move counter_move;
+        std::array<const Types::HistoryTable*, Constants::CONTINUATION_PLIES.size()> continuation_tables{};
+        if constexpr (gen_type != Types::MoveGenType::CAPTURE) {
+
+            for (std::size_t cont_ind = 0; cont_ind < Constants::CONTINUATION_PLIES.size(); ++cont_ind) {
+                const Move         prev_move  = this->position.get_previous_move(Constants::CONTINUATION_PLIES[cont_ind]);
+                const Types::Piece prev_piece = this->position.get_previous_moved_piece(Constants::CONTINUATION_PLIES[cont_ind]);
+
+                // no previous move (root or null move)
+                if (prev_move.is_null()) {continue;}
+
+                continuation_tables[cont_ind] = &(this->heuristics.continuation_history[prev_piece][prev_move.get_to_square()]);
+
+                if (Constants::CONTINUATION_PLIES[cont_ind] == 1) {
+                    counter_move = this->heuristics.counter_moves[prev_piece][prev_move.get_to_square()];
+                }
+            }
+        }
+
         for (OrderedMove& move : this->move_list) {
 
             // 1. hash/tt move
@@ -121,14 +146,19 @@ public:
 
             // 2. capture
             else if (move.is_capture()) {
-                
-                const Types::PieceType attacker = piece_type(this->position.moved_piece(move));
-                const Types::PieceType victim   = (move.is_enpassant()) ? Types::PieceType::PAWN :
-                                                                          piece_type(this->position.captured_piece(move));
-
-                // score captures directly below tt moves
-                const Types::MoveScore score = Constants::CAPTURE_SCORE_OFFSET + Constants::MVVLVA_SCORES[victim][attacker];
-                move.set_score(score);
+
+                const Types::Piece     attacker = this->position.moved_piece(move);
+                const Types::PieceType victim   = piece_type(this->position.captured_piece(move));
+
+                // mvv + capture history
+                const Types::MoveScore capture_score = Constants::MVV_SCORE_SCALE * Constants::PIECE_SCORES[victim]
+                                                     + Constants::MAX_HISTORY_SCORE
+                                                     + this->heuristics.capture_history[attacker][move.get_to_square()][victim];
+
+                // score winning/equal captures directly below tt moves and losing captures below quiets
+                const Types::MoveScore offset = (static_exchange_evaluation(this->position, move) >= 0) ? Constants::GOOD_CAPTURE_SCORE_OFFSET
+                                                                                                        : Constants::BAD_CAPTURE_SCORE_OFFSET;
+                move.set_score(offset + capture_score);
             }
 
 
@@ -136,22 +166,30 @@ public:
             // TODO : setting score here makes child nodes not affect upper depth search order
             else {
                 // killer move
-                // placing directory below minimum capture score
-                if (const auto& p_kmove = std::find(Engine::killer_table[this->position.get_ply_played()].begin(), 
-                                                    Engine::killer_table[this->position.get_ply_played()].end(),
-                                                    move);
-                    p_kmove != Engine::killer_table[this->position.get_ply_played()].end())
-                {
-                    const Types::MoveScore score = Constants::KILLER_SCORE_OFFSET;
-                    move.set_score(score);
+                // placing directly below minimum capture score
+                if (move == this->killers[0]) {
+                    move.set_score(Constants::KILLER_SCORE_OFFSET);
+                }
+                else if (move == this->killers[1]) {
+                    move.set_score(Constants::KILLER_SCORE_OFFSET - 1);
+                }
+                // counter move
+                else if (move == counter_move) {
+                    move.set_score(Constants::COUNTER_MOVE_SCORE);
                 }
                 // history move
                 else {
                     const Types::Square to = move.get_to_square();
                     const Types::Piece  p  = this->position.moved_piece(move);
 
-                    // TODO : make sure none of these scores are larger than any capture score
-                    const Types::MoveScore score = Engine::history_table[p][to];
+                    int history_score = this->heuristics.history[p][to];
+                    for (const Types::HistoryTable* p_continuation_table : continuation_tables) {
+                        if (p_continuation_table != nullptr) {
+                            history_score += (*p_continuation_table)[p][to];
+                        }
+                    }
+
+                    const Types::MoveScore score = Constants::QUIET_SCORE_OFFSET + history_score;
                     move.set_score(score);
                 }
             }
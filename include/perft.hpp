@@ -2,12 +2,29 @@
 
 #pragma once
 
+#include "defs.hpp" // types, constants
+#include "move.hpp" // move
+
+#include <vector>   // vector
+#include <atomic>   // atomic
+#include <ostream>  // ostream
+#include <string>   // string
+
+
 namespace MPChess {
 
 // forward declarations
 class Board;
 
 
+namespace Constants {
+
+inline constexpr std::size_t  DEFAULT_PERFT_TABLE_SIZE_MB = 64;
+inline constexpr unsigned int DEFAULT_PERFT_SUITE_DEPTH   =  6;
+
+} // Constants namespace
+
+
 namespace Types {
 
 struct PerftInfo {
@@ -18,9 +35,72 @@ struct PerftInfo {
     unsigned long long checks     = 0;
 };
 
+// subtree node count of a position at a depth
+// check is key ^ nodes, so an entry torn by two threads writing at once fails the key check (lockless hashing)
+struct PerftEntry {
+    std::atomic<uint64_t> check{0}; // 8 bytes
+    std::atomic<uint64_t> nodes{0}; // 8 bytes
+};
+
+// nodes below a root move
+struct PerftDivide {
+    Move               move;
+    unsigned long long nodes;
+};
+
+struct PerftResult {
+    unsigned long long       nodes = 0;
+    Milliseconds             time{0};
+    std::vector<PerftDivide> divide; // per root move
+};
+
 } // Types namespace
 
 
+// perft hash table, shared by all perft threads
+
+class PerftTable {
+private:
+
+    std::size_t                    table_size; // number of entries
+    std::vector<Types::PerftEntry> table;
+
+public:
+
+    // constructors
+    PerftTable(std::size_t table_size_mb = Constants::DEFAULT_PERFT_TABLE_SIZE_MB);
+
+
+    // store/probe
+    bool probe(Types::Key key, unsigned int depth, unsigned long long& nodes) const;
+    void store(Types::Key key, unsigned int depth, unsigned long long nodes);
+};
+
+
+// perft
+// without perft info, leaves are counted from the number of legal moves at depth 1 (bulk counting)
 unsigned long long perft(unsigned int depth, Board& board, Types::PerftInfo* p_perft_info=nullptr);
 
+// bulk counting perft with subtree counts cached in table
+unsigned long long perft(unsigned int depth, Board& board, PerftTable& table);
+
+// multi-threaded hashed perft
+// from depth 3 the tree is split into one task per root move and reply,
+// threads pull the next task until none are left and share one table of table_size_mb
+Types::PerftResult parallel_perft(const Board& board, unsigned int depth, std::size_t num_threads,
+                                  std::size_t table_size_mb = Constants::DEFAULT_PERFT_TABLE_SIZE_MB);
+
+// divide (nodes per root move), nodes, time and nps
+std::ostream& operator<<(std::ostream& os, const Types::PerftResult& result);
+
+
+// perft suite
+// runs every EPD position with ";D<depth> <nodes>" expectations up to max_depth, positions are split over num_threads
+// each thread has its own table of table_size_mb / num_threads
+// stops at the first mismatch and prints the divide of that position at its shallowest failing depth
+// returns true if every position matched
+
+bool perft_suite(const std::string& epd_path, std::size_t num_threads, std::size_t table_size_mb,
+                 unsigned int max_depth = Constants::DEFAULT_PERFT_SUITE_DEPTH);
+
 } // MPChess namespace
\ No newline at end of file
@@ -28,11 +28,11 @@ namespace Rng {
     public:
 
         // constructors
-        XorShift64() : state{Rng::DEFAULT_SEED} {
+        constexpr XorShift64() : state{Rng::DEFAULT_SEED} {
 
         }
 
-        XorShift64(uint64_t initial_state) : state{initial_state} {
+        constexpr XorShift64(uint64_t initial_state) : state{initial_state} {
             assert(this->state);
         }
         
@@ -43,9 +43,10 @@ namespace Rng {
 
 
         // generate pseudo random numbers
+        // constexpr, so tables can be filled at compile time (e.g. zobrist keys)
 
         template<RngType rng_type = RngType::NORMAL>
-        uint64_t generate() {
+        constexpr uint64_t generate() {
 
             // normal rng
             if constexpr (rng_type == RngType::NORMAL) {
@@ -62,7 +63,7 @@ namespace Rng {
         }
 
         template<std::size_t N, RngType rng_type = RngType::NORMAL>
-        std::array<uint64_t, N> generate_N() {
+        constexpr std::array<uint64_t, N> generate_N() {
 
             std::array<uint64_t, N> pseudo_random_nums;
             for (auto& num : pseudo_random_nums) {
@@ -6,16 +6,69 @@
 
 #include "movelist.hpp" // movelist
 
+#include <array>        // array
+
 
 namespace MPChess {
 
+namespace Constants {
+
+// lazy smp depth skipping (https://www.chessprogramming.org/Lazy_SMP)
+// helper thread i (from 1) skips a depth if (depth + game ply + SMP_SKIP_PHASES[j]) / SMP_SKIP_SIZES[j] is odd,
+// j = (i - 1) % 20, so helpers are spread over the current and the next few depths
+inline constexpr std::array<std::size_t, 20> SMP_SKIP_SIZES  = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+inline constexpr std::array<std::size_t, 20> SMP_SKIP_PHASES = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+
+// best thread vote offset, (score - lowest score + offset) * depth, so the lowest scoring thread still votes by its depth
+inline constexpr int64_t SMP_VOTE_MIN_WEIGHT = 14;
+
+} // Constants namespace
+
+
+// mate scores
+//
+// mate scores are relative to the root (MATE - plies from root to mate),
+// but tt entries are shared between positions at different search plies,
+// so they are stored relative to the node (MATE - plies from node to mate)
+// and converted back when probed
+
+// score of being mated at ply / giving mate at ply
+constexpr Types::Eval mated_in(std::size_t ply) {return -Constants::Evals::MATE + static_cast<Types::Eval>(ply);}
+constexpr Types::Eval mate_in(std::size_t ply)  {return  Constants::Evals::MATE - static_cast<Types::Eval>(ply);}
+
+constexpr bool is_mate_score(Types::Eval eval) {
+    return eval >=  Constants::Evals::MATE_IN_MAX_PLY
+        || eval <= -Constants::Evals::MATE_IN_MAX_PLY;
+}
+
+// number of moves (not plies) until mate, negative if side to move is mated
+constexpr int mate_in_moves(Types::Eval eval) {
+    return (eval > 0) ?  (Constants::Evals::MATE - eval + 1) / 2
+                      : -(Constants::Evals::MATE + eval)     / 2;
+}
+
+// root relative -> node relative
+constexpr Types::Eval score_to_tt(Types::Eval eval, std::size_t ply) {
+    if (eval >=  Constants::Evals::MATE_IN_MAX_PLY) {return eval + static_cast<Types::Eval>(ply);}
+    if (eval <= -Constants::Evals::MATE_IN_MAX_PLY) {return eval - static_cast<Types::Eval>(ply);}
+    return eval;
+}
+
+// node relative -> root relative
+constexpr Types::Eval score_from_tt(Types::Eval eval, std::size_t ply) {
+    if (eval >=  Constants::Evals::MATE_IN_MAX_PLY) {return eval - static_cast<Types::Eval>(ply);}
+    if (eval <= -Constants::Evals::MATE_IN_MAX_PLY) {return eval + static_cast<Types::Eval>(ply);}
+    return eval;
+}
+
+
 // Forward declarations
 class  EngineThread;
 
 // EngineThread friend search functions
 
 Types::Eval search(EngineThread& thread);
-Types::Eval alpha_beta(EngineThread& thread, Types::Depth depth, Types::Eval alpha, Types::Eval beta, bool root, RegularMoveList& pv_parent);
-Types::Eval quiescence(EngineThread& thread, Types::Eval alpha, Types::Eval beta);
+Types::Eval alpha_beta(EngineThread& thread, Types::Depth depth, Types::Eval alpha, Types::Eval beta, std::size_t ply);
+Types::Eval quiescence(EngineThread& thread, Types::Eval alpha, Types::Eval beta, std::size_t ply, std::size_t qs_ply);
 
 } // MPChess namespace
\ No newline at end of file
@@ -0,0 +1,51 @@
+// searchstack.hpp
+
+#pragma once
+
+#include "defs.hpp"     // types, constants
+#include "move.hpp"     // move
+#include "movelist.hpp" // movelist
+
+#include <array>        // array
+
+
+namespace MPChess {
+
+namespace Types {
+
+using KillerMoves = std::array<Move, Constants::NUM_KILLER_MOVES>;
+
+} // Types namespace
+
+
+// per-ply search data
+// indexed by search ply (distance from root), not game ply
+
+struct SearchStackEntry {
+    RegularMoveList    pv;      // principal variation starting at this ply
+    Types::KillerMoves killers; // quiet moves that caused a beta cutoff at this ply
+
+    // killers are probed for every quiet move, so compare both slots directly
+    static_assert(Constants::NUM_KILLER_MOVES == 2);
+
+    bool is_killer(Move move) const {
+        return move == this->killers[0] || move == this->killers[1];
+    }
+
+    void add_killer(Move move) {
+        if (move != this->killers[0]) {
+            this->killers[1] = this->killers[0];
+            this->killers[0] = move;
+        }
+    }
+
+    void reset() {
+        this->pv.shrink(0);
+        this->killers.fill(Move{});
+    }
+};
+
+// one extra entry so nodes at MAX_SEARCH_PLY can still reset their entry
+using SearchStack = std::array<SearchStackEntry, Constants::MAX_SEARCH_PLY + 1>;
+
+} // MPChess namespace
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include "defs.hpp"           // types
 #include "board.hpp"          // board
 #include "movelist.hpp"       // movelist
+#include "history.hpp"        // history, counter move, continuation tables
+#include "searchstack.hpp"    // search stack (pv, killers)
 
 #include <thread>             // thread
 #include <atomic>             // atomics
@@ -22,11 +24,20 @@ namespace MPChess {
 struct SearchInfo;
 
 
+namespace Constants {
+
+// node counts are published (and the main thread checks time/node limits) every SEARCH_STOP_CHECK_NODES nodes
+inline constexpr uint64_t SEARCH_STOP_CHECK_NODES = 1024;
+
+} // Constants namespace
+
+
 namespace Types {
 
 enum class EngineThreadStatus : int {
     IDLE,
     RUNNING,
+    CLEARING,
     EXITING
 };
 
@@ -37,20 +48,48 @@ enum class EnginePoolStatus : int {
 
 } // Types namespace
 
+// per-thread search data
+// allocated once per thread and cache line aligned,
+// so no two threads ever write to the same cache line
+
+struct alignas(Constants::CACHE_LINE_SIZE) ThreadData {
+
+    HeuristicTables heuristics;
+    SearchStack     stack;
+
+    void reset();
+};
+
+
 class EngineThread {
 private:
 
     std::size_t id;
     std::atomic<Types::EngineThreadStatus> status;
-    std::thread thread;
+    bool                                   busy = false; // running a job (guarded by mutex)
 
     std::mutex              mutex;
     std::condition_variable cv;
 
-    Board           root_board;
-    RegularMoveList root_moves;
-    
-    std::atomic<uint64_t> node_counter;
+    Board               root_board;
+    RegularMoveList     root_moves;
+    std::vector<PVLine> pv_lines;
+    Types::Depth        completed_depth = 0; // last depth searched to the end (pv_lines are of this depth)
+
+    std::unique_ptr<ThreadData> data;
+
+    // search counters, only touched by this thread (on their own cache line)
+    alignas(Constants::CACHE_LINE_SIZE)
+    uint64_t node_counter              = 0;
+    uint64_t cutoff_counter            = 0; // beta cutoffs
+    uint64_t first_move_cutoff_counter = 0; // beta cutoffs on first legal move
+
+    // node counter as read by other threads, stored every SEARCH_STOP_CHECK_NODES nodes and at the end of a search
+    alignas(Constants::CACHE_LINE_SIZE)
+    std::atomic<uint64_t> published_node_counter;
+
+    // started last, after all other members are initialized
+    std::thread thread;
 
 public:
 
@@ -73,13 +112,33 @@ public:
     void stop_search();
     void wait_until_stopped();
     bool check_stop() const;
+    void count_node();
+    void publish_node_counter();
+
+
+    // thread data (heuristics, search stack)
+
+    void start_clear();
 
 
     // search
 
     friend Types::Eval search(EngineThread& thread);
-    friend Types::Eval alpha_beta(EngineThread& thread, Types::Depth depth, Types::Eval alpha, Types::Eval beta, bool root, RegularMoveList& pv_parent);
-    friend Types::Eval quiescence(EngineThread& thread, Types::Eval alpha, Types::Eval beta);
+    friend Types::Eval alpha_beta(EngineThread& thread, Types::Depth depth, Types::Eval alpha, Types::Eval beta, std::size_t ply);
+    friend Types::Eval quiescence(EngineThread& thread, Types::Eval alpha, Types::Eval beta, std::size_t ply, std::size_t qs_ply);
+
+
+    // search results (read once the thread stopped)
+
+    const PVLine& get_pv_line() const;
+    Types::Depth  get_completed_depth() const;
+
+
+    // search stats
+
+    uint64_t get_node_counter() const;
+    uint64_t get_cutoff_counter() const;
+    uint64_t get_first_move_cutoff_counter() const;
 
 
     // utils
@@ -87,12 +146,27 @@ public:
     bool is_main_thread() const;
 };
 
+// counts a searched node, every SEARCH_STOP_CHECK_NODES nodes the count is published
+// and the main thread checks the search limits (no atomics or clock reads per node)
+inline void EngineThread::publish_node_counter() {
+    this->published_node_counter.store(this->node_counter, std::memory_order_relaxed);
+}
+
+inline void EngineThread::count_node() {
+    if (++(this->node_counter) % Constants::SEARCH_STOP_CHECK_NODES == 0) [[unlikely]] {
+        this->publish_node_counter();
+        if (this->is_main_thread()) {
+            this->check_stop();
+        }
+    }
+}
+
 
 class EngineThreadPool {
 private:
 
     std::size_t                                num_threads;
-    std::atomic<Types::EnginePoolStatus>       status;
+    std::atomic<Types::EnginePoolStatus>       status; // the stop flag polled by every searching thread
     std::vector<std::unique_ptr<EngineThread>> thread_pool;
 
 public:
@@ -102,16 +176,37 @@ public:
     EngineThreadPool(std::size_t num_threads = 1);
 
 
+    // number of threads
+
+    std::size_t get_num_threads() const;
+    void        set_num_threads(std::size_t num_threads);
+
+
     // status
 
-    bool is_running() const;
+    bool is_running() const {
+        return this->status.load(std::memory_order_relaxed) == Types::EnginePoolStatus::RUNNING;
+    }
     void start_search(SearchInfo&& search_info);
     void stop_search();
+    void signal_stop();
+    void wait_until_stopped();
+    void wait_for_helpers();
+
+
+    // lazy smp best thread vote (once all threads stopped)
+
+    const EngineThread& best_thread() const;
+
+
+    // thread data (heuristics, search stack)
+
+    void clear_thread_data();
 
 
     // utils
 
-    uint64_t sum_threads(std::atomic<uint64_t> EngineThread::* member) const;
+    uint64_t sum_threads(uint64_t (EngineThread::* getter)() const) const;
 
 };
 
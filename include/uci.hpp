@@ -28,9 +28,14 @@ Move uci_notation_to_move(std::string_view notation, const Board& board);
 
 void print_welcome();
 void uci_loop();
+bool parse_command(const std::string& line);
 
 void parse_position(std::istringstream& stream);
+void parse_setoption(std::istringstream& stream);
 void parse_go(std::istringstream& stream);
+void parse_mate_batch(std::istringstream& stream);
+void parse_perft_suite(std::istringstream& stream);
+void parse_bench(std::istringstream& stream);
 
 } // UCI namespace
 
@@ -2,35 +2,61 @@
 
 #pragma once
 
-#include "defs.hpp" // types, constants
-#include "rng.hpp"  // xorshift rng
+#include "defs.hpp"  // types, constants
+#include "utils.hpp" // file_index
+#include "rng.hpp"   // xorshift rng
 
-#include <array>    // array
+#include <array>     // array
 
 
 namespace MPChess {
 
-// forward declaration
-class Board;
+namespace Zobrist {
 
+    // hashes
+    // all keys come from one xorshift stream with a fixed seed and are generated at compile time,
+    // so every build (and every translation unit) sees the same keys and keys can be persisted
+    struct Hashes {
+        std::array<std::array<Types::Key, Constants::NUM_SQUARES>, Constants::NUM_PIECES> piece_square; // [piece][square]
+        std::array<Types::Key, Constants::NUM_FILES>                                      enpassant;
+        std::array<Types::Key, Constants::NUM_CASTLE_STATES>                              castle;
+        Types::Key                                                                        color;
+    };
 
-namespace Zobrist {
+    inline constexpr uint64_t ZOBRIST_SEED = Rng::DEFAULT_SEED;
 
-    // hash getters    
-    Types::Key get_piece_square_key(Types::Piece p, Types::Square sq);
-    Types::Key get_enpassant_key(Types::Square sq);
-    Types::Key get_castle_key(Types::Castle c);
-    Types::Key get_color_key();
+    inline constexpr Hashes HASHES = [] consteval {
 
-    // hashes
-    namespace Hashes {
+        Rng::XorShift64 rng{ZOBRIST_SEED};
+        Hashes hashes{};
+
+        for (auto& piece_keys : hashes.piece_square) {
+            piece_keys = rng.generate_N<Constants::NUM_SQUARES>();
+        }
+        hashes.enpassant = rng.generate_N<Constants::NUM_FILES>();
+        hashes.castle    = rng.generate_N<Constants::NUM_CASTLE_STATES>();
+        hashes.color     = rng.generate();
+
+        return hashes;
+    }();
+
+
+    // hash getters
+    constexpr Types::Key get_piece_square_key(Types::Piece p, Types::Square sq) {
+        return HASHES.piece_square[p][sq];
+    }
+
+    constexpr Types::Key get_enpassant_key(Types::Square sq) {
+        return HASHES.enpassant[file_index(sq)];
+    }
 
-    const std::array<Types::Key, Constants::NUM_PIECES*Constants::NUM_SQUARES> piece_square = Rng::main_rng.generate_N<Constants::NUM_PIECES*Constants::NUM_SQUARES>();
-    const std::array<Types::Key, Constants::NUM_FILES>                         enpassant    = Rng::main_rng.generate_N<Constants::NUM_FILES>();
-    const std::array<Types::Key, Constants::NUM_CASTLE_STATES>                 castle       = Rng::main_rng.generate_N<Constants::NUM_CASTLE_STATES>();
-    const Types::Key                                                           color        = Rng::main_rng.generate();
+    constexpr Types::Key get_castle_key(Types::Castle c) {
+        return HASHES.castle[c];
+    }
 
-    } // Hashes namespace
+    constexpr Types::Key get_color_key() {
+        return HASHES.color;
+    }
 
 } // Zobrist namespace
 
@@ -0,0 +1,122 @@
+// attacks.cpp
+// slider lookup tables, generated at compile time from the magic numbers in magics.hpp
+
+#include "attacks.hpp"
+
+#include "defs.hpp"  // types, constants
+#include "utils.hpp" // pop_count
+
+using namespace MPChess::Types;
+using namespace MPChess::Constants;
+
+
+namespace MPChess {
+
+namespace Attacks {
+
+namespace Magics {
+
+// software pext (_pext_u64 is not constexpr)
+// gathers the bits of value selected by mask into the low bits of the result
+static consteval uint64_t parallel_bits_extract(uint64_t value, uint64_t mask) {
+
+    uint64_t result = 0;
+    for (uint64_t bit = 1; mask; bit <<= 1) {
+        if (value & mask & -mask) {result |= bit;}
+        mask &= mask - 1;
+    }
+
+    return result;
+}
+
+template<PieceType slider, SliderBackend backend>
+static consteval std::size_t attacks_index(Square sq, Bitboard blockers) {
+    if constexpr (backend == SliderBackend::PEXT) {
+        return parallel_bits_extract(blockers, relevant_blocker_mask<slider>(sq));
+    }
+    else {
+        return (magic_numbers<slider>()[sq].magic * blockers) >> magic_numbers<slider>()[sq].key_shift;
+    }
+}
+
+// attacks of a slider on one square start at the sum of the table sizes of the previous squares
+template<PieceType slider, SliderBackend backend>
+static consteval std::size_t attacks_offset(Square sq) {
+
+    std::size_t offset = 0;
+    for (std::size_t ind = 0; ind < sq; ++ind) {
+        if constexpr (backend == SliderBackend::MAGIC) {offset += 1ull << (64 - magic_numbers<slider>()[ind].key_shift);}
+        else                                           {offset += 1ull << pop_count(relevant_blocker_mask<slider>(static_cast<Square>(ind)));}
+    }
+
+    // rooks follow bishops
+    if constexpr (slider == PieceType::ROOK) {offset += slider_table_size<PieceType::BISHOP, backend>();}
+
+    return offset;
+}
+
+// fill attacks of every blocker subset ("Carry-Ripple" iteration)
+template<PieceType slider, SliderBackend backend>
+static consteval void fill_slider_attacks(SliderAttacks<backend>& attacks) {
+
+    for (const Square& sq : ALL_SQUARES) {
+        const Bitboard    relevant_blockers = relevant_blocker_mask<slider>(sq);
+        const std::size_t offset            = attacks_offset<slider, backend>(sq);
+
+        Bitboard blocker_subset{EMPTY};
+        do {
+            blocker_subset = (blocker_subset - relevant_blockers) & relevant_blockers;
+            attacks[offset + attacks_index<slider, backend>(sq, blocker_subset)] = slider_attacks<slider>(sq, blocker_subset);
+        } while (blocker_subset);
+    }
+}
+
+template<SliderBackend backend>
+static consteval SliderAttacks<backend> generate_slider_attacks() {
+
+    SliderAttacks<backend> attacks{};
+
+    fill_slider_attacks<PieceType::BISHOP, backend>(attacks);
+    fill_slider_attacks<PieceType::ROOK,   backend>(attacks);
+
+    return attacks;
+}
+
+template<PieceType slider, SliderBackend backend>
+static consteval MagicTable generate_slider_entries(const Bitboard* attacks) {
+
+    MagicTable entries{};
+
+    for (const Square& sq : ALL_SQUARES) {
+        entries[sq].blockers_mask = relevant_blocker_mask<slider>(sq);
+        entries[sq].magic         = (backend == SliderBackend::MAGIC) ? magic_numbers<slider>()[sq].magic     : 0;
+        entries[sq].key_shift     = (backend == SliderBackend::MAGIC) ? magic_numbers<slider>()[sq].key_shift : 0;
+        entries[sq].attacks       = attacks + attacks_offset<slider, backend>(sq);
+    }
+
+    return entries;
+}
+
+} // Magics namespace
+
+
+namespace Tables {
+
+// one contiguous attacks table per backend, entries point into it
+static constexpr Magics::SliderAttacks<SliderBackend::MAGIC> MAGIC_SLIDER_ATTACKS = Magics::generate_slider_attacks<SliderBackend::MAGIC>();
+
+constinit const Magics::MagicTable BISHOP_MAGIC_ENTRIES = Magics::generate_slider_entries<PieceType::BISHOP, SliderBackend::MAGIC>(MAGIC_SLIDER_ATTACKS.data());
+constinit const Magics::MagicTable ROOK_MAGIC_ENTRIES   = Magics::generate_slider_entries<PieceType::ROOK,   SliderBackend::MAGIC>(MAGIC_SLIDER_ATTACKS.data());
+
+#ifdef MPCHESS_USE_PEXT
+static constexpr Magics::SliderAttacks<SliderBackend::PEXT> PEXT_SLIDER_ATTACKS = Magics::generate_slider_attacks<SliderBackend::PEXT>();
+
+constinit const Magics::MagicTable BISHOP_PEXT_ENTRIES = Magics::generate_slider_entries<PieceType::BISHOP, SliderBackend::PEXT>(PEXT_SLIDER_ATTACKS.data());
+constinit const Magics::MagicTable ROOK_PEXT_ENTRIES   = Magics::generate_slider_entries<PieceType::ROOK,   SliderBackend::PEXT>(PEXT_SLIDER_ATTACKS.data());
+#endif
+
+} // Tables namespace
+
+} // Attacks namespace
+
+} // MPChess namespace
\ No newline at end of file
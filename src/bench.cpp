@@ -0,0 +1,68 @@
+// bench.cpp
+
+#include "bench.hpp"
+
+#include "defs.hpp"       // types, constants
+#include "utils.hpp"      // current_time
+
+#include "board.hpp"      // board
+#include "searchinfo.hpp" // searchinfo
+#include "engine.hpp"     // engine globals
+
+#include <string>         // string
+#include <iostream>       // cout
+
+using namespace MPChess::Types;
+using namespace MPChess::Constants;
+
+
+namespace MPChess {
+
+void bench(Depth depth, std::size_t num_threads, std::size_t hash_size_mb) {
+
+    Engine::thread_pool.stop_search();
+
+    const Board engine_board{Engine::engine_board};
+    Engine::thread_pool.set_num_threads(num_threads);
+    Engine::tt.resize(hash_size_mb);
+
+    uint64_t     total_nodes = 0;
+    Milliseconds total_time{0};
+
+    for (std::size_t index = 0; index < BENCH_FENS.size(); ++index) {
+        std::cout << "position " << index + 1 << "/" << BENCH_FENS.size() << " " << BENCH_FENS[index] << "\n";
+
+        // every position starts from the same state (deterministic node count)
+        Engine::tt.reset();
+        Engine::thread_pool.clear_thread_data();
+        Engine::engine_board.set_fen(std::string(BENCH_FENS[index]));
+
+        SearchInfo bench_search_info;
+        bench_search_info.start_time = current_time();
+        bench_search_info.max_depth  = depth;
+
+        Engine::thread_pool.start_search(std::move(bench_search_info));
+        Engine::thread_pool.wait_until_stopped();
+
+        total_time  += current_time() - Engine::search_info.start_time;
+        total_nodes += Engine::thread_pool.sum_threads(&EngineThread::get_node_counter);
+    }
+
+    // restore engine settings
+    Engine::thread_pool.set_num_threads(Engine::options.num_threads);
+    Engine::tt.resize(Engine::options.hash_size_mb);
+    engine_board.clone_into(Engine::engine_board);
+
+    const auto time_spent = total_time.count();
+
+    std::cout << "\n"
+              << "depth "   << depth        << "\n"
+              << "threads " << num_threads  << "\n"
+              << "hash "    << hash_size_mb << " mb\n"
+              << "time "    << time_spent   << " ms\n"
+              << "nodes "   << total_nodes  << "\n"
+              << "nps "     << ((time_spent > 0) ? 1000 * total_nodes / time_spent : 0) << "\n"
+              << std::endl;
+}
+
+} // MPChess namespace
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "utils.hpp"   // operators, etc.
 
 #include "zobrist.hpp" // zobrist hashes
+#include "cuckoo.hpp"  // cuckoo tables
 
 #include <string>      // string
 
@@ -13,6 +14,7 @@
 #include <sstream>     // istringstream
 #include <stdexcept>   // exceptions
 #include <cmath>       // ceil
+#include <algorithm>   // copy
 
 using namespace MPChess::Types;
 using namespace MPChess::Constants;
@@ -31,6 +33,43 @@ Board::Board(std::string&& fen) {
 }
 
 
+// copying
+
+Board::Board(const Board& board) {
+    board.clone_into(*this);
+}
+
+Board& Board::operator= (const Board& board) {
+    if (this != &board) {
+        board.clone_into(*this);
+    }
+    return *this;
+}
+
+void Board::clone_into(Board& board) const {
+
+    // board
+    board.type_bbs      = this->type_bbs;
+    board.occupancy_bbs = this->occupancy_bbs;
+    board.pieces        = this->pieces;
+
+    // game state variables
+    board.zobrist_key      = this->zobrist_key;
+    board.ply_played       = this->ply_played;
+    board.ply_move_number  = this->ply_move_number;
+    board.ply_clock        = this->ply_clock;
+    board.side_to_move     = this->side_to_move;
+    board.enpassant_square = this->enpassant_square;
+    board.castling_rights  = this->castling_rights;
+
+    // state/move history, entries past ply_played are stale
+    if (board.state_history.size() < this->ply_played + MAX_SEARCH_PLY) {
+        board.state_history.resize(this->ply_played + MAX_SEARCH_PLY);
+    }
+    std::copy(this->state_history.begin(), this->state_history.begin() + this->ply_played, board.state_history.begin());
+}
+
+
 // set/get fen
 
 void Board::set_fen(std::string&& fen) {
@@ -43,7 +82,7 @@ void Board::set_fen(std::string&& fen) {
     // 1. read board/pieces
 
     // clear board/pieces
-    std::fill(this->piece_bbs.begin(), this->piece_bbs.end(), EMPTY);
+    std::fill(this->type_bbs.begin(), this->type_bbs.end(), EMPTY);
     this->occupancy_bbs = {EMPTY, EMPTY, UNIVERSE}; // white, black, unoccupied
     std::fill(this->pieces.begin(), this->pieces.end(), Piece::NO_PIECE);
 
@@ -66,8 +105,11 @@ void Board::set_fen(std::string&& fen) {
         else if (std::size_t piece_index = PIECE_LABELS.find(c); piece_index != PIECE_LABELS.npos) {
             
             // add piece to board
-            this->piece_bbs[piece_index] |= square_to_bitboard(sq);
-            this->pieces[sq] = static_cast<Piece>(piece_index); 
+            const Piece piece = static_cast<Piece>(piece_index);
+            this->type_bbs[piece_type(piece)]       |= square_to_bitboard(sq);
+            this->occupancy_bbs[piece_color(piece)] |= square_to_bitboard(sq);
+            this->occupancy_bbs[NO_COLOR]           ^= square_to_bitboard(sq);
+            this->pieces[sq] = piece;
         }
 
         // invalid char
@@ -81,13 +123,6 @@ void Board::set_fen(std::string&& fen) {
         }
     }
 
-    // update occupancy bitboards
-    for (const Piece& piece : ALL_PIECES) {
-        const Color color = piece_color(piece);
-        this->occupancy_bbs[color] ^= this->piece_bbs[piece];
-        this->occupancy_bbs[NO_COLOR]  ^= this->piece_bbs[piece];
-    }
-
 
     // 2. read color to move
     stream >> chunk;
@@ -140,7 +175,9 @@ void Board::set_fen(std::string&& fen) {
 
     // reset moves played
     this->ply_played = 0;
-    this->move_list.shrink(0);
+    if (this->state_history.size() < MAX_SEARCH_PLY) {
+        this->state_history.resize(MAX_SEARCH_PLY);
+    }
 
     // generate zobrist key
     this->generate_key();
@@ -229,17 +266,26 @@ Bitboard Board::get_piece_bb(Piece p) const {
         return this->get_occupation_bb(Color::NO_COLOR);
     }
     else {
-        return this->piece_bbs[p];
+        return this->type_bbs[piece_type(p)] & this->occupancy_bbs[piece_color(p)];
     }
 }
 
 Bitboard Board::get_piece_bb(Color c, PieceType pt) const {
-    return this->get_piece_bb(color_type_to_piece(c, pt));
+    if (c == Color::NO_COLOR || pt == PieceType::NO_PIECE_TYPE) {
+        return this->get_occupation_bb(Color::NO_COLOR);
+    }
+    else {
+        return this->type_bbs[pt] & this->occupancy_bbs[c];
+    }
 }
 
 Bitboard Board::get_piece_type_bb(PieceType pt) const {
-    return this->get_piece_bb(color_type_to_piece(Color::WHITE, pt))
-         | this->get_piece_bb(color_type_to_piece(Color::BLACK, pt));
+    if (pt == PieceType::NO_PIECE_TYPE) {
+        return this->get_occupation_bb(Color::NO_COLOR);
+    }
+    else {
+        return this->type_bbs[pt];
+    }
 }
 
 Color Board::get_side_to_move() const {
@@ -274,81 +320,151 @@ Key Board::get_zobrist_key() const {
     return this->zobrist_key;
 }
 
-const RegularMoveList& Board::get_move_list() const {
-    return this->move_list;
+Move Board::get_previous_move(std::size_t plies_ago) const {
+    if (plies_ago == 0 || plies_ago > this->ply_played) {return {};} // null move
+    return this->state_history[this->ply_played - plies_ago].move;
+}
+
+Piece Board::get_previous_moved_piece(std::size_t plies_ago) const {
+    if (plies_ago == 0 || plies_ago > this->ply_played) {return Piece::NO_PIECE;}
+    return this->state_history[this->ply_played - plies_ago].piece_moved;
 }
 
 
 // make/unmake move
 
+void Board::make_move(Move move) {
+    if (this->side_to_move == Color::WHITE) {this->make_move<Color::WHITE>(move);}
+    else                                    {this->make_move<Color::BLACK>(move);}
+}
+
+void Board::unmake_move() {
+    const Move prev_move = this->state_history[this->ply_played - 1].move;
+
+    if (this->side_to_move == Color::BLACK) {this->unmake_move<Color::WHITE>(prev_move);}
+    else                                    {this->unmake_move<Color::BLACK>(prev_move);}
+}
+
+template<Color side>
+void Board::make_move(Move move) {
+    switch (move.get_flag()) {
+        case Constants::Move::Flags::QUIET:            this->make_move<side, MoveKind::QUIET>(move);            break;
+        case Constants::Move::Flags::DOUBLE_PAWN_PUSH: this->make_move<side, MoveKind::DOUBLE_PAWN_PUSH>(move); break;
+        case Constants::Move::Flags::SHORT_CASTLE:
+        case Constants::Move::Flags::LONG_CASTLE:      this->make_move<side, MoveKind::CASTLE>(move);           break;
+        case Constants::Move::Flags::CAPTURE:          this->make_move<side, MoveKind::CAPTURE>(move);          break;
+        case Constants::Move::Flags::ENPASSANT:        this->make_move<side, MoveKind::ENPASSANT>(move);        break;
+        default:
+            if (move.is_capture()) {this->make_move<side, MoveKind::PROMOTE_CAPTURE>(move);}
+            else                   {this->make_move<side, MoveKind::PROMOTE>(move);}
+    }
+}
+
+template<Color side>
+void Board::unmake_move(Move move) {
+    switch (move.get_flag()) {
+        case Constants::Move::Flags::QUIET:            this->unmake_move<side, MoveKind::QUIET>(move);            break;
+        case Constants::Move::Flags::DOUBLE_PAWN_PUSH: this->unmake_move<side, MoveKind::DOUBLE_PAWN_PUSH>(move); break;
+        case Constants::Move::Flags::SHORT_CASTLE:
+        case Constants::Move::Flags::LONG_CASTLE:      this->unmake_move<side, MoveKind::CASTLE>(move);           break;
+        case Constants::Move::Flags::CAPTURE:          this->unmake_move<side, MoveKind::CAPTURE>(move);          break;
+        case Constants::Move::Flags::ENPASSANT:        this->unmake_move<side, MoveKind::ENPASSANT>(move);        break;
+        default:
+            if (move.is_capture()) {this->unmake_move<side, MoveKind::PROMOTE_CAPTURE>(move);}
+            else                   {this->unmake_move<side, MoveKind::PROMOTE>(move);}
+    }
+}
+
+template<Color side, MoveKind kind>
 void Board::make_move(Move move) {
 #ifndef NDEBUG
     this->validate();
 #endif
 
+    constexpr Color  enemy             = (side == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    constexpr Castle castle_color_mask = (side == Color::WHITE) ? CastlingRights::W_BOTH : CastlingRights::B_BOTH;
+    constexpr bool   is_capture        = (kind == MoveKind::CAPTURE || kind == MoveKind::ENPASSANT || kind == MoveKind::PROMOTE_CAPTURE);
+    constexpr bool   is_promote        = (kind == MoveKind::PROMOTE || kind == MoveKind::PROMOTE_CAPTURE);
+
     // get all move info
-    const Color& color_moved    = this->side_to_move;
-    const Piece  piece_captured = this->captured_piece(move);
-    const Square from           = move.get_from_square();
-    const Square to             = move.get_to_square(); 
+    const Square from = move.get_from_square();
+    const Square to   = move.get_to_square();
+
+    Square square_captured = to;
+    if constexpr (kind == MoveKind::ENPASSANT) {
+        square_captured = (side == Color::WHITE) ? step<StepType::S>(to)
+                                                 : step<StepType::N>(to);
+    }
+    const Piece piece_captured = (is_capture) ? this->pieces[square_captured] : Piece::NO_PIECE;
 
     // add state to history
-    this->state_history[this->ply_played] = {
+    this->push_state({
         .zobrist_key      = this->zobrist_key,
+        .move             = move,
         .ply_clock        = this->ply_clock,
         .enpassant_square = this->enpassant_square,
         .castling_rights  = this->castling_rights,
 
+        .piece_moved      = this->pieces[from],
         .piece_captured   = piece_captured
-    };
-    this->move_list.add_move(move);
+    });
 
-    // castle: move castle rook
-    if (move.is_castle()) {
+    // key changes of color, enpassant and castling rights are applied at once (pieces update the key as they move)
+    Key key_delta = Zobrist::get_color_key();
 
-        const Castle castle_color_mask = (color_moved == Color::WHITE) ? CastlingRights::W_BOTH
-                                                                       : CastlingRights::B_BOTH;
+    // remove old enpassant square
+    if (this->enpassant_square != Square::NO_SQUARE) {
+        key_delta              ^= Zobrist::get_enpassant_key(this->enpassant_square);
+        this->enpassant_square  = Square::NO_SQUARE;
+    }
 
+    // castle: move castle rook (king is moved below)
+    if constexpr (kind == MoveKind::CASTLE) {
         const auto [rook_from, rook_to] = castle_rook_from_to(move.get_castle() & castle_color_mask);
-
-        // move rook
         this->move_piece(rook_from, rook_to);
-
-        // king is moved below
     }
 
-    // capture: removed captured piece
-    if (move.is_capture()) {
-        const Square square_captured = this->captured_square(move);
+    // capture: remove captured piece
+    if constexpr (is_capture) {
         this->remove_piece(square_captured);
     }
 
-    // move piece (non-promote)
-    if (!move.is_promote()) {
+    // move piece, or replace the pawn by the promoted piece
+    if constexpr (is_promote) {
+        this->remove_piece(from);
+        this->add_piece(to, color_type_to_piece(side, move.get_promote_piece_type()));
+    }
+    else {
         this->move_piece(from, to);
     }
 
+    // double pawn push: enpassant square if adjacent to an enemy pawn
+    if constexpr (kind == MoveKind::DOUBLE_PAWN_PUSH) {
+        const Bitboard adjacent_sqs = step<StepType::E>(to)
+                                    | step<StepType::W>(to);
 
-    // pawn promotion
-    else {
-        this->remove_piece(from);
-
-        const Piece piece_promote = color_type_to_piece(color_moved, move.get_promote_piece_type());
-        this->add_piece(to, piece_promote);
+        if (!is_empty(adjacent_sqs & this->get_piece_bb(enemy, PieceType::PAWN))) {
+            this->enpassant_square = (side == Color::WHITE) ? step<StepType::S>(to)
+                                                            : step<StepType::N>(to);
+            key_delta ^= Zobrist::get_enpassant_key(this->enpassant_square);
+        }
     }
 
-    // update enpassant
-    this->update_enpassant_square(move);
+    // update castling rights (from and to squares of kings and rooks)
+    const Castle castling_rights = this->castling_rights
+                                 & CASTLING_RIGHTS_MASKS[from]
+                                 & CASTLING_RIGHTS_MASKS[to];
 
-    // update castle state (if any remaining)
-    this->update_castling_rights(move);
+    key_delta ^= Zobrist::get_castle_key(this->castling_rights)
+              ^  Zobrist::get_castle_key(castling_rights);
+    this->castling_rights = castling_rights;
 
-    // update color
-    this->side_to_move = ~(this->side_to_move);
-    this->zobrist_key ^= Zobrist::get_color_key();
+    // update key and color
+    this->zobrist_key  ^= key_delta;
+    this->side_to_move  = enemy;
 
-    // update move counters
-    if (move.is_capture() || piece_type(piece_captured) == PieceType::PAWN) {
+    // update move counters (captures and pawn moves are irreversible)
+    if (is_capture || is_promote || kind == MoveKind::DOUBLE_PAWN_PUSH || piece_type(this->pieces[to]) == PieceType::PAWN) {
         this->ply_clock = 0;
     }
     else {
@@ -363,61 +479,46 @@ void Board::make_move(Move move) {
 #endif
 }
 
-void Board::unmake_move() {
+template<Color side, MoveKind kind>
+void Board::unmake_move(Move move) {
 
 #ifndef NDEBUG
     this->validate();
 #endif 
 
-    // get previous move info
-    const Move&      prev_move  = this->move_list[this->ply_played - 1];
-    const StateInfo& prev_state = this->state_history[this->ply_played - 1];  
-
-    const Color& color_moved = ~this->side_to_move;
-    const Square from        = prev_move.get_from_square();
-    const Square to          = prev_move.get_to_square();
-
+    constexpr Castle castle_color_mask = (side == Color::WHITE) ? CastlingRights::W_BOTH : CastlingRights::B_BOTH;
 
-    // castle : move rook back
-    if (prev_move.is_castle()) {
+    // get previous move info
+    const StateInfo& prev_state = this->state_history[this->ply_played - 1];
 
-        const Castle castle_color_mask = (color_moved == Color::WHITE) ? CastlingRights::W_BOTH
-                                                                       : CastlingRights::B_BOTH;
-        const auto [rook_from, rook_to] = castle_rook_from_to(prev_move.get_castle() & castle_color_mask);
+    const Square from = move.get_from_square();
+    const Square to   = move.get_to_square();
 
-        // move rook back
-        this->move_piece(rook_to, rook_from);
+    // the key is restored from history, so pieces are moved without key updates
 
-        // king moved back below
+    // castle : move rook back (king moved back below)
+    if constexpr (kind == MoveKind::CASTLE) {
+        const auto [rook_from, rook_to] = castle_rook_from_to(move.get_castle() & castle_color_mask);
+        this->move_piece<false>(rook_to, rook_from);
     }
 
-    // move piece back (non-promote)
-    if (!prev_move.is_promote()) {
-        this->move_piece(to, from);
+    // move piece back, or replace the promoted piece by the pawn
+    if constexpr (kind == MoveKind::PROMOTE || kind == MoveKind::PROMOTE_CAPTURE) {
+        this->remove_piece<false>(to);
+        this->add_piece<false>(from, color_type_to_piece(side, PieceType::PAWN));
     }
-
-    // move piece back (promote)
     else {
-        this->remove_piece(to);
-        this->add_piece(from, color_type_to_piece(color_moved, PieceType::PAWN));
+        this->move_piece<false>(to, from);
     }
 
     // capture : place captured piece back
-    if (prev_move.is_capture()) {
-        
-        // enpassant capture
-        if (prev_move.is_enpassant()) {
-            
-            const Square square_captured = (color_moved == Color::WHITE) ? step<StepType::S>(to)
-                                                                         : step<StepType::N>(to);
-
-            this->add_piece(square_captured, prev_state.piece_captured);
-        }
-
-        // regular capture
-        else {
-            this->add_piece(to, prev_state.piece_captured);
-        }        
+    if constexpr (kind == MoveKind::ENPASSANT) {
+        const Square square_captured = (side == Color::WHITE) ? step<StepType::S>(to)
+                                                              : step<StepType::N>(to);
+        this->add_piece<false>(square_captured, prev_state.piece_captured);
+    }
+    else if constexpr (kind == MoveKind::CAPTURE || kind == MoveKind::PROMOTE_CAPTURE) {
+        this->add_piece<false>(to, prev_state.piece_captured);
     }
 
     // restore irreversible state info
@@ -431,10 +532,7 @@ void Board::unmake_move() {
     --(this->ply_played);
 
     // color to move
-    this->side_to_move = color_moved;
-
-    // movelist update
-    this->move_list.shrink(this->move_list.get_size() - 1);
+    this->side_to_move = side;
 
 #ifndef NDEBUG
     this->validate();
@@ -444,14 +542,15 @@ void Board::unmake_move() {
 void Board::make_null_move() {
 
     // add state to history
-    this->state_history[this->ply_played] = {
+    this->push_state({
         .zobrist_key      = this->zobrist_key,
+        .move             = Move{},
         .ply_clock        = this->ply_clock,
         .enpassant_square = this->enpassant_square,
         .castling_rights  = this->castling_rights,
+        .piece_moved      = Piece::NO_PIECE,
         .piece_captured   = Piece::NO_PIECE
-    };
-    this->move_list.add_move(Move{});
+    });
 
     // remove enpassant square
     if (this->enpassant_square != Square::NO_SQUARE) {
@@ -480,151 +579,9 @@ void Board::unmake_null_move() {
     // color to move
     this->side_to_move = ~(this->side_to_move);
 
-    // movelist update
-    this->move_list.shrink(this->move_list.get_size() - 1);
     --(this->ply_played);
 }
 
-void Board::update_enpassant_square(Move move) {
-
-    // get move info
-    const Square to          = move.get_to_square();
-    const Color  color_moved = this->side_to_move;
-
-    // remove old enpassant square
-    if (!is_empty(this->enpassant_square)) {
-        this->zobrist_key      ^= Zobrist::get_enpassant_key(this->enpassant_square);
-        this->enpassant_square  = Square::NO_SQUARE;
-    }
-
-    // double pawn push (check for new enpassant square)
-    if (move.is_double_pawn_push()) {
-        const Bitboard adjacent_sqs = step<StepType::E>(to)
-                                    | step<StepType::W>(to);
-
-        const Bitboard& enemy_pawns = this->piece_bbs[color_type_to_piece(~color_moved, PieceType::PAWN)];
-
-        // adjacent to enemy pawn
-        if (!is_empty(adjacent_sqs & enemy_pawns)) {
-            this->enpassant_square = (color_moved == Color::WHITE) ? step<StepType::S>(to)
-                                                                   : step<StepType::N>(to);
-        }
-    }
-}
-
-void Board::update_castling_rights(Move move) {
-
-    // no castling rights remaining
-    if (this->castling_rights == CastlingRights::NONE) {return;}
-
-    // unhash key for current castling rights
-    this->zobrist_key ^= Zobrist::get_castle_key(this->castling_rights);
-
-    // get move info
-    const Piece&    piece_moved      = this->pieces[move.get_to_square()];
-    const PieceType piece_type_moved = piece_type(piece_moved);
-    const Color     color_moved      = piece_color(piece_moved);
-    const Color     color_enemy      = ~color_moved;
-
-    const Piece&    piece_captured      = this->state_history[this->ply_played].piece_captured; // note history has been updated but move counters have not
-    const PieceType piece_type_captured = piece_type(piece_captured);
-
-    const Castle castle_color_mask = (color_moved == Color::WHITE) ? CastlingRights::W_BOTH
-                                                                   : CastlingRights::B_BOTH;
-
-    // king move : remove all castle rights for color moved
-    if (piece_type_moved == PieceType::KING) {
-        this->castling_rights &= ~(castle_color_mask);
-    }
-
-    // rook move : remove castle rights for rook side for color moved
-    if (piece_type_moved == PieceType::ROOK) {
-
-        const Square rook_from_long_castle  = (color_moved == Color::WHITE) ? Square::A1
-                                                                            : Square::A8;
-        const Square rook_from_short_castle = (color_moved == Color::WHITE) ? Square::H1
-                                                                            : Square::H8;
-
-        // moved queen side rook: remove long castle
-        if (rook_from_long_castle == move.get_from_square()) {
-            this->castling_rights &= ~(castle_color_mask & CastlingRights::W_LONG_B_LONG);
-        }
-
-        // moved king side rook : remove short castle
-        else if (rook_from_short_castle == move.get_from_square()) {
-            this->castling_rights &= ~(castle_color_mask & CastlingRights::W_SHORT_B_SHORT);
-        }
-    }
-
-    // rook captured : remove castle rights for rook side for color captured
-    if (piece_type_captured == PieceType::ROOK) {
-
-        const Square rook_from_long_castle  = (color_enemy == Color::WHITE) ? Square::A1
-                                                                            : Square::A8;
-        const Square rook_from_short_castle = (color_enemy == Color::WHITE) ? Square::H1
-                                                                            : Square::H8;
-
-        // note capture square is always to square, because cannot enpassant capture on first/last rank
-
-        // captured queen side rook : remove long castle
-        if (rook_from_long_castle == move.get_to_square()) {
-            this->castling_rights &= ~(~castle_color_mask & CastlingRights::W_LONG_B_LONG);
-        }
-
-        // captured king side rook : remove short castle
-        else if (rook_from_short_castle == move.get_to_square()) {
-            this->castling_rights &= ~(~castle_color_mask & CastlingRights::W_SHORT_B_SHORT);
-        }
-    }
-
-    // update zobrist with new castling rights
-    this->zobrist_key ^= Zobrist::get_castle_key(this->castling_rights);
-}
-
-void Board::remove_piece(Square sq) {
-    const Piece captured_piece = this->pieces[sq];
-    const Color captured_color = piece_color(captured_piece);
-
-    // remove piece from bitboards
-    this->pieces[sq]                      = Piece::NO_PIECE;
-    this->piece_bbs[captured_piece]      ^= square_to_bitboard(sq);
-    this->occupancy_bbs[captured_color]  ^= square_to_bitboard(sq);
-    this->occupancy_bbs[Color::NO_COLOR] |= square_to_bitboard(sq);
-
-    // update zobrist key
-    this->zobrist_key ^= Zobrist::get_piece_square_key(captured_piece, sq);
-}
-
-void Board::add_piece(Square sq, Piece p) {
-    const Color color_piece = piece_color(p);
-
-    // add piece to bitboards
-    this->pieces[sq]    = p;
-    this->piece_bbs[p]                   |= square_to_bitboard(sq);
-    this->occupancy_bbs[color_piece]     |= square_to_bitboard(sq);
-    this->occupancy_bbs[Color::NO_COLOR] ^= square_to_bitboard(sq);
-
-    // update zobrist key
-    this->zobrist_key ^= Zobrist::get_piece_square_key(p, sq);
-}
-
-void Board::move_piece(Square from, Square to) {
-    const Piece piece_moved = this->pieces[from];
-    const Color color_moved = piece_color(piece_moved);
-
-    // move piece
-    this->pieces[from] = Piece::NO_PIECE;
-    this->pieces[to]   = piece_moved;
-
-    this->piece_bbs[piece_moved]         ^= (from | to);
-    this->occupancy_bbs[color_moved]     ^= (from | to);
-    this->occupancy_bbs[Color::NO_COLOR] ^= (from | to);
-
-    // update zobrist key
-    this->zobrist_key ^= Zobrist::get_piece_square_key(piece_moved, from)
-                      ^  Zobrist::get_piece_square_key(piece_moved, to);
-}
-
 Square Board::captured_square(Move move) const {
     if (!move.is_capture()) {return Square::NO_SQUARE;}
 
@@ -648,6 +605,7 @@ Square Board::captured_square(Move move) const {
 }
 
 Piece Board::captured_piece(Move move) const {
+    if (!move.is_capture()) {return Piece::NO_PIECE;}
     return this->pieces[this->captured_square(move)];
 }
 
@@ -667,7 +625,7 @@ Bitboard Board::is_double_occupied() const {
 
     for (const Piece& p : ALL_PIECES) {
 
-        const Bitboard& piece_bb = this->piece_bbs[p];
+        const Bitboard piece_bb = this->get_piece_bb(p);
 
         if (is_empty(occupied & piece_bb)) {occupied |= piece_bb;}
         else                               {return occupied & piece_bb;}
@@ -685,7 +643,7 @@ Bitboard Board::is_occupation_mismatch() const {
         Bitboard color_bb = EMPTY;
 
         for (const PieceType& pt : ALL_PIECE_TYPES) {
-            color_bb |= this->piece_bbs[color_type_to_piece(c, pt)];
+            color_bb |= this->get_piece_bb(c, pt);
         }
 
         if (color_bb != this->occupancy_bbs[c]) {return color_bb ^ this->occupancy_bbs[c];}
@@ -717,13 +675,55 @@ void Board::validate() const {
 }
 
 bool Board::is_repetition() const {
-    if (this->ply_clock <= 3) {return false;}
+    if (this->ply_clock < 4) {return false;}
+
+    // positions since the last irreversible move (that are in the history)
+    const std::size_t num_plies = std::min<std::size_t>(this->ply_clock, this->ply_played);
+    if (num_plies < 4) {return false;}
+
+    // positions before a null move are not reached by moves, so they do not repeat
+    // (the loop checks the two moves after each compared position, the last two are checked here)
+    if (this->state_history[this->ply_played - 1].move.is_null() || this->state_history[this->ply_played - 2].move.is_null()) {return false;}
+
+    // only positions with the same side to move (2 plies ago can not be equal)
+    for (std::size_t plies_ago = 4; plies_ago <= num_plies; plies_ago += 2) {
+        const StateInfo& state = this->state_history[this->ply_played - plies_ago];
+
+        if (state.move.is_null() || this->state_history[this->ply_played - plies_ago + 1].move.is_null()) {return false;}
+        if (state.zobrist_key == this->zobrist_key) {return true;}
+    }
+
+    return false;
+}
+
+bool Board::has_upcoming_repetition(std::size_t ply) const {
+    if (this->ply_clock < 3) {return false;}
+
+    const std::size_t num_plies = std::min<std::size_t>(this->ply_clock, this->ply_played);
+
+    if (num_plies < 3 || this->state_history[this->ply_played - 1].move.is_null()) {return false;}
+
+    // other is zero when the moves of the side not to move, since plies_ago, cancel out
+    // then the position plies_ago is one move of the side to move away (if that move is in the cuckoo table and not blocked)
+    Key other = this->zobrist_key ^ this->state_history[this->ply_played - 1].zobrist_key ^ Zobrist::get_color_key();
+
+    for (std::size_t plies_ago = 3; plies_ago <= num_plies; plies_ago += 2) {
+        const StateInfo& prev_state = this->state_history[this->ply_played - plies_ago + 1];
+        const StateInfo& state      = this->state_history[this->ply_played - plies_ago];
+
+        if (state.move.is_null() || prev_state.move.is_null()) {return false;}
+
+        other ^= prev_state.zobrist_key ^ state.zobrist_key ^ Zobrist::get_color_key();
+        if (other != 0) {continue;}
+
+        const std::size_t index = Cuckoo::find(this->zobrist_key ^ state.zobrist_key);
+        if (index == CUCKOO_TABLE_SIZE) {continue;}
+
+        const Square from = Cuckoo::CUCKOO_TABLE.from_squares[index];
+        const Square to   = Cuckoo::CUCKOO_TABLE.to_squares[index];
 
-    for (auto p_state  = this->state_history.rbegin() + 1;
-              p_state != this->state_history.rbegin() + 1 + this->ply_clock;
-            ++p_state)
-    {
-        if (p_state->zobrist_key == this->zobrist_key) {
+        // the repeated position must be within the search (a repetition before the root is not a draw yet)
+        if (is_empty(Attacks::inbetween_squares(from, to) & ~this->occupancy_bbs[Color::NO_COLOR]) && ply > plies_ago) {
             return true;
         }
     }
@@ -731,6 +731,127 @@ bool Board::is_repetition() const {
     return false;
 }
 
+// checks
+
+CheckInfo Board::get_check_info() const {
+
+    CheckInfo check_info;
+
+    const Color    color_friend = this->side_to_move;
+    const Color    color_enemy  = ~color_friend;
+    const Square   enemy_king   = bitboard_to_square(this->get_piece_bb(color_enemy, PieceType::KING));
+    const Bitboard friendly     = this->get_occupation_bb(color_friend);
+    const Bitboard enemy        = this->get_occupation_bb(color_enemy);
+    const Bitboard occupied     = ~this->get_occupation_bb(Color::NO_COLOR);
+
+    const Bitboard friend_diagonal = this->get_piece_bb(color_friend, PieceType::BISHOP) | this->get_piece_bb(color_friend, PieceType::QUEEN);
+    const Bitboard friend_straight = this->get_piece_bb(color_friend, PieceType::ROOK)   | this->get_piece_bb(color_friend, PieceType::QUEEN);
+
+    check_info.enemy_king = enemy_king;
+
+    // direct checks
+    // a piece gives check from the squares it would attack if it stood on the enemy king square
+    const Bitboard diagonal_checks = Attacks::attacks<PieceType::BISHOP>(enemy_king, occupied);
+    const Bitboard straight_checks = Attacks::attacks<PieceType::ROOK>(enemy_king, occupied);
+
+    check_info.check_squares[PieceType::PAWN]   = (color_friend == Color::WHITE) ? Attacks::attacks<PieceType::PAWN, Color::BLACK>(enemy_king)
+                                                                                 : Attacks::attacks<PieceType::PAWN, Color::WHITE>(enemy_king);
+    check_info.check_squares[PieceType::KNIGHT] = Attacks::attacks<PieceType::KNIGHT>(enemy_king);
+    check_info.check_squares[PieceType::BISHOP] = diagonal_checks;
+    check_info.check_squares[PieceType::ROOK]   = straight_checks;
+    check_info.check_squares[PieceType::QUEEN]  = diagonal_checks | straight_checks;
+    check_info.check_squares[PieceType::KING]   = EMPTY;
+
+    // discovered checks
+    // friendly sliders that see the enemy king through friendly pieces only,
+    // a single friendly blocker gives check by leaving the line to the enemy king
+    check_info.discover_candidates = EMPTY;
+
+    Bitboard snipers = (Attacks::attacks<PieceType::BISHOP>(enemy_king, enemy) & friend_diagonal)
+                     | (Attacks::attacks<PieceType::ROOK>(enemy_king, enemy)   & friend_straight);
+    while (snipers) {
+        const Square   sniper   = pop_lsb(snipers);
+        const Bitboard blockers = Attacks::inbetween_squares(enemy_king, sniper) & occupied;
+
+        if (pop_count(blockers) == 1 && (blockers & friendly)) {
+            check_info.discover_candidates |= blockers;
+        }
+    }
+
+    return check_info;
+}
+
+bool Board::gives_check(Move move, const CheckInfo& check_info) const {
+
+    const Square   from       = move.get_from_square();
+    const Square   to         = move.get_to_square();
+    const Square   enemy_king = check_info.enemy_king;
+    const Bitboard occupied   = ~this->get_occupation_bb(Color::NO_COLOR);
+
+    // direct check (promotions below)
+    if (!move.is_promote() && (check_info.check_squares[piece_type(this->pieces[from])] & to)) {return true;}
+
+    // discovered check
+    if ((check_info.discover_candidates & from) && !(Attacks::line_through(enemy_king, from) & to)) {return true;}
+
+    // promotion: promoted piece attacks the king from the to square, the from square is empty
+    if (move.is_promote()) {
+        const Bitboard occupancy = occupied & ~square_to_bitboard(from);
+
+        switch (move.get_promote_piece_type()) {
+            case PieceType::KNIGHT: return Attacks::attacks<PieceType::KNIGHT>(to) & enemy_king;
+            case PieceType::BISHOP: return Attacks::attacks<PieceType::BISHOP>(to, occupancy) & enemy_king;
+            case PieceType::ROOK:   return Attacks::attacks<PieceType::ROOK>(to, occupancy)   & enemy_king;
+            case PieceType::QUEEN:  return Attacks::attacks<PieceType::QUEEN>(to, occupancy)  & enemy_king;
+            default:                return false;
+        }
+    }
+
+    // enpassant: captured pawn and moved pawn can both discover a slider
+    if (move.is_enpassant()) {
+        const Color    color_friend = this->side_to_move;
+        const Bitboard occupancy    = (occupied & ~(from | this->captured_square(move))) | to;
+
+        const Bitboard friend_diagonal = this->get_piece_bb(color_friend, PieceType::BISHOP) | this->get_piece_bb(color_friend, PieceType::QUEEN);
+        const Bitboard friend_straight = this->get_piece_bb(color_friend, PieceType::ROOK)   | this->get_piece_bb(color_friend, PieceType::QUEEN);
+
+        return (Attacks::attacks<PieceType::BISHOP>(enemy_king, occupancy) & friend_diagonal)
+            || (Attacks::attacks<PieceType::ROOK>(enemy_king, occupancy)   & friend_straight);
+    }
+
+    // castle: castled rook attacks the king
+    if (move.is_castle()) {
+        const Castle castle_color_mask = (this->side_to_move == Color::WHITE) ? CastlingRights::W_BOTH
+                                                                              : CastlingRights::B_BOTH;
+
+        const auto [king_from, king_to] = castle_king_from_to(move.get_castle() & castle_color_mask);
+        const auto [rook_from, rook_to] = castle_rook_from_to(move.get_castle() & castle_color_mask);
+
+        const Bitboard occupancy = (occupied & ~(king_from | rook_from)) | king_to | rook_to;
+
+        return Attacks::attacks<PieceType::ROOK>(rook_to, occupancy) & enemy_king;
+    }
+
+    return false;
+}
+
+bool Board::gives_check(Move move) const {
+    return this->gives_check(move, this->get_check_info());
+}
+
+
+// state history
+
+void Board::push_state(const StateInfo& state) {
+
+    // game outlasted the history
+    if (this->ply_played == this->state_history.size()) [[unlikely]] {
+        this->state_history.resize(2 * this->state_history.size());
+    }
+
+    this->state_history[this->ply_played] = state;
+}
+
 
 // zobrist key methods
 
@@ -823,7 +944,7 @@ void Board::print(std::ostream& os) const {
     // print previous move
     if (this->ply_played > 0) {
         os << "\nPrevious Move: ";
-        print_move(this->move_list[this->ply_played - 1]);
+        print_move(this->get_previous_move());
     }
 }
 
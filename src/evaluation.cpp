@@ -5,6 +5,10 @@
 #include "defs.hpp"  // types, constants
 #include "utils.hpp" // pop_count
 #include "board.hpp" // board
+#include "move.hpp"  // move
+
+#include <array>     // array
+#include <algorithm> // max
 
 using namespace MPChess::Types;
 using namespace MPChess::Constants;
@@ -56,4 +60,64 @@ Eval evaluate(const Board& board) {
                                                       : -score;
 }
 
+// static exchange evaluation
+// https://www.chessprogramming.org/SEE_-_The_Swap_Algorithm
+//
+// material gain (from side to move) of the capture sequence on the to square
+// where each side recaptures with its least valuable attacker and
+// may stop capturing at any point (x-rays are found by recalculating
+// attackers after each capture, pins are ignored)
+Eval static_exchange_evaluation(const Board& board, Move move) {
+
+    const Square to   = move.get_to_square();
+    const Square from = move.get_from_square();
+
+    // captured piece (enpassant captured square is not the to square)
+    const Piece captured = board.captured_piece(move);
+    if (captured == Piece::NO_PIECE) {return 0;}
+
+    std::array<int, 32> gain;
+    std::size_t         d = 0;
+
+    Bitboard  occupied      = ~board.get_occupation_bb(Color::NO_COLOR);
+    Color     side          = board.get_side_to_move();
+    PieceType attacker_type = piece_type(board.moved_piece(move));
+
+    gain[d]   = PIECE_SCORES[piece_type(captured)];
+    occupied ^= square_to_bitboard(from) | square_to_bitboard(board.captured_square(move));
+
+    while (d + 1 < gain.size()) {
+
+        // next capture is by the other side
+        side = ~side;
+        ++d;
+
+        // speculative gain if the last attacker is captured
+        gain[d] = PIECE_SCORES[attacker_type] - gain[d-1];
+        if (std::max(-gain[d-1], gain[d]) < 0) {break;}
+
+        // least valuable attacker of side
+        const Bitboard attackers = board.attacks_to(to, occupied)
+                                 & board.get_occupation_bb(side)
+                                 & occupied;
+        if (is_empty(attackers)) {break;}
+
+        for (const PieceType& pt : ALL_PIECE_TYPES) {
+            const Bitboard pt_attackers = attackers & board.get_piece_bb(side, pt);
+            if (!is_empty(pt_attackers)) {
+                occupied     ^= square_to_bitboard(lsb(pt_attackers));
+                attacker_type = pt;
+                break;
+            }
+        }
+    }
+
+    // negamax the gains (each side may stop capturing)
+    while (--d) {
+        gain[d-1] = -std::max(-gain[d-1], gain[d]);
+    }
+
+    return static_cast<Eval>(gain[0]);
+}
+
 } // MPChess namespace
\ No newline at end of file
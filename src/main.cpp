@@ -3,7 +3,22 @@
 #include "uci.hpp"
 #include "engine.hpp"
 
-auto main() -> int { 
+#include <string>
+
+// any command line arguments are run as a single command (e.g. "main matebatch mates.epd 4", "main bench")
+// otherwise start the uci loop
+auto main(int argc, char* argv[]) -> int { 
+
+    if (argc > 1) {
+        std::string command;
+        for (int arg_ind = 1; arg_ind < argc; ++arg_ind) {
+            command += std::string(argv[arg_ind]) + " ";
+        }
+
+        MPChess::UCI::parse_command(command);
+        MPChess::Engine::thread_pool.stop_search();
+        return 0;
+    }
 
     MPChess::UCI::print_welcome();
 
@@ -0,0 +1,365 @@
+// matesearch.cpp
+
+#include "matesearch.hpp"
+
+#include "defs.hpp"    // types, constants
+#include "utils.hpp"   // current_time
+#include "movegen.hpp" // movegen
+
+#include "uci.hpp"     // move_to_uci_notation
+
+#include <atomic>      // atomic
+#include <thread>      // thread
+#include <fstream>     // ifstream
+#include <sstream>     // stringstream
+#include <iostream>    // cout
+#include <algorithm>   // min
+
+using namespace MPChess::Types;
+using namespace MPChess::Constants;
+
+
+namespace MPChess {
+
+// utils
+
+// the same position with a different number of remaining plies is a different node
+static Key node_key(const Board& board, std::size_t remaining) {
+    return board.get_zobrist_key() ^ (remaining * 0x9E3779B97F4A7C15ull);
+}
+
+static uint32_t saturated_add(uint32_t a, uint32_t b) {
+    return static_cast<uint32_t>(std::min<uint64_t>(uint64_t{a} + b, PROOF_INF));
+}
+
+// legal moves of the side to move (with resulting node keys)
+// on the last attacker ply only checking moves can mate, the others are dropped with gives_check
+// before they are made (only kept moves are made, for their keys)
+struct MateChildren {
+    RegularMoveList          moves;
+    std::array<Key, MAX_PLY> keys;
+};
+
+static void generate_children(Board& board, std::size_t remaining, bool checks_only, MateChildren& children) {
+
+    RegularMoveList legal_moves;
+    generate_moves<MoveGenType::LEGAL>(board, legal_moves);
+
+    const CheckInfo check_info = (checks_only) ? board.get_check_info() : CheckInfo{};
+
+    for (const Move& move : legal_moves) {
+        if (checks_only && !board.gives_check(move, check_info)) {continue;}
+
+        board.make_move(move);
+        children.keys[children.moves.get_size()] = node_key(board, remaining - 1);
+        children.moves.add_move(move);
+        board.unmake_move();
+    }
+}
+
+
+// MateTable
+
+MateTable::MateTable(std::size_t table_size_mb) :
+    table_size{std::max<std::size_t>((table_size_mb * 1024 * 1024) / sizeof(MateBucket), 1)},
+    table(table_size)
+{
+
+}
+
+void MateTable::resize(std::size_t size_mb) {
+    this->table_size = std::max<std::size_t>((size_mb * 1024 * 1024) / sizeof(MateBucket), 1);
+    this->table.assign(this->table_size, MateBucket{});
+}
+
+void MateTable::reset() {
+    std::fill(this->table.begin(), this->table.end(), MateBucket{});
+}
+
+bool MateTable::probe(Key key, uint32_t& phi, uint32_t& delta) const {
+    const MateBucket& bucket = this->table[key % this->table_size];
+
+    for (const MateEntry& entry : bucket) {
+        if (entry.key == key) {
+            phi   = entry.phi;
+            delta = entry.delta;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// replace the same key, otherwise the entry with the least proof/disproof work
+// (solved entries have phi + delta >= PROOF_INF, so they are kept the longest)
+void MateTable::store(Key key, uint32_t phi, uint32_t delta) {
+    MateBucket& bucket = this->table[key % this->table_size];
+
+    MateEntry* p_replace = &bucket[0];
+    for (MateEntry& entry : bucket) {
+        if (entry.key == key) {
+            p_replace = &entry;
+            break;
+        }
+
+        if (uint64_t{entry.phi} + entry.delta < uint64_t{p_replace->phi} + p_replace->delta) {
+            p_replace = &entry;
+        }
+    }
+
+    *p_replace = {key, phi, delta};
+}
+
+
+// MateSolver
+
+MateSolver::MateSolver(std::size_t table_size_mb) :
+    table{table_size_mb}
+{
+
+}
+
+MateTable& MateSolver::get_table() {
+    return this->table;
+}
+
+void MateSolver::mid(Board& board, std::size_t remaining, uint32_t th_phi, uint32_t th_delta) {
+
+    // stop check
+    ++(this->nodes);
+    if (this->nodes % MATE_STOP_CHECK_NODES == 0 && this->should_stop && this->should_stop()) {
+        this->stopped = true;
+    }
+    if (this->stopped) {return;}
+
+    // attacker to move on odd remaining plies (root has 2n - 1)
+    const bool attacker = (remaining % 2 == 1);
+    const Key  key      = node_key(board, remaining);
+
+    MateChildren children;
+    generate_children(board, remaining, attacker && remaining == 1, children);
+
+    // terminal nodes
+    if (children.moves.get_size() == 0) {
+
+        // defender stalemated, attacker failed
+        if (!attacker && !board.is_check<true>()) {
+            this->table.store(key, 0, PROOF_INF);
+        }
+        // defender mated, or attacker has no (checking) moves left
+        else {
+            this->table.store(key, PROOF_INF, 0);
+        }
+        return;
+    }
+
+    // defender survived all plies
+    if (remaining == 0) {
+        this->table.store(key, 0, PROOF_INF);
+        return;
+    }
+
+    while (true) {
+
+        // phi = min child delta, delta = sum of child phi
+        uint32_t    phi        = PROOF_INF;
+        uint32_t    delta      = 0;
+        uint32_t    delta_2    = PROOF_INF; // second smallest child delta
+        uint32_t    phi_best   = PROOF_INF;
+        std::size_t best_index = 0;
+
+        for (std::size_t child_ind = 0; child_ind < children.moves.get_size(); ++child_ind) {
+            uint32_t child_phi   = 1;
+            uint32_t child_delta = 1;
+            this->table.probe(children.keys[child_ind], child_phi, child_delta);
+
+            delta = saturated_add(delta, child_phi);
+
+            if (child_delta < phi) {
+                delta_2    = phi;
+                phi        = child_delta;
+                phi_best   = child_phi;
+                best_index = child_ind;
+            }
+            else if (child_delta < delta_2) {
+                delta_2 = child_delta;
+            }
+        }
+
+        // over threshold (or solved)
+        if (phi >= th_phi || delta >= th_delta || this->stopped) {
+            this->table.store(key, phi, delta);
+            return;
+        }
+
+        // search most proving child
+        const uint32_t child_th_phi   = static_cast<uint32_t>(std::min<uint64_t>(uint64_t{th_delta} + phi_best - delta, PROOF_INF));
+        const uint32_t child_th_delta = std::min(th_phi, saturated_add(delta_2, 1));
+
+        board.make_move(children.moves[best_index]);
+        this->mid(board, remaining - 1, child_th_phi, child_th_delta);
+        board.unmake_move();
+    }
+}
+
+// follow proven children through the table
+void MateSolver::extract_pv(Board& board, std::size_t remaining, RegularMoveList& pv) {
+
+    std::size_t plies_made = 0;
+    while (remaining > 0) {
+
+        const bool attacker = (remaining % 2 == 1);
+
+        MateChildren children;
+        generate_children(board, remaining, attacker && remaining == 1, children);
+
+        Move next_move;
+        for (std::size_t child_ind = 0; child_ind < children.moves.get_size(); ++child_ind) {
+            uint32_t child_phi, child_delta;
+            if (!this->table.probe(children.keys[child_ind], child_phi, child_delta)) {continue;}
+
+            // attacker: child (defender) loses, defender: child (attacker) wins
+            if ((attacker && child_delta == 0) || (!attacker && child_phi == 0)) {
+                next_move = children.moves[child_ind];
+                break;
+            }
+        }
+
+        if (next_move.is_null()) {break;}
+
+        board.make_move(next_move);
+        pv.add_move(next_move);
+        ++plies_made;
+        --remaining;
+    }
+
+    for (; plies_made > 0; --plies_made) {
+        board.unmake_move();
+    }
+}
+
+MateResult MateSolver::solve(Board& board, std::size_t max_moves, std::function<bool()> should_stop) {
+
+    this->should_stop = std::move(should_stop);
+    this->nodes       = 0;
+    this->stopped     = false;
+
+    MateResult result;
+
+    for (std::size_t n = 1; n <= max_moves && 2 * n - 1 < MAX_SEARCH_PLY; ++n) {
+        const std::size_t remaining = 2 * n - 1;
+
+        this->mid(board, remaining, PROOF_INF, PROOF_INF);
+
+        if (this->stopped) {
+            result.stopped = true;
+            break;
+        }
+
+        uint32_t phi, delta;
+        if (this->table.probe(node_key(board, remaining), phi, delta) && phi == 0) {
+            result.proven    = true;
+            result.mate_in_n = n;
+            this->extract_pv(board, remaining, result.pv);
+            break;
+        }
+    }
+
+    result.nodes = this->nodes;
+    return result;
+}
+
+
+// batch mode
+
+struct MateBatchPosition {
+    std::string fen;
+    std::size_t mate_in_n;
+};
+
+void mate_batch(const std::string& epd_path, std::size_t num_threads, std::size_t table_size_mb) {
+
+    // parse epd, "<4 fen fields> [opcode operand;]...", keep positions with "dm N;"
+    std::ifstream epd_file(epd_path);
+    if (!epd_file) {
+        std::cout << "info string cannot open " << epd_path << "\n";
+        return;
+    }
+
+    std::vector<MateBatchPosition> positions;
+    std::string line;
+    while (std::getline(epd_file, line)) {
+        std::istringstream stream(line);
+
+        std::string fen, chunk;
+        for (std::size_t field = 0; field < 4 && stream >> chunk; ++field) {
+            fen += chunk + " ";
+        }
+
+        while (stream >> chunk) {
+            if (chunk == "dm" && stream >> chunk) {
+                positions.push_back({fen + "0 1", std::stoul(chunk)});
+                break;
+            }
+        }
+    }
+
+    num_threads = std::max<std::size_t>(num_threads, 1);
+
+    std::vector<MateResult> results(positions.size());
+    std::atomic<std::size_t> next_index = 0;
+
+    const auto start_time = current_time();
+
+    std::vector<std::thread> workers;
+    for (std::size_t thread_id = 0; thread_id < num_threads; ++thread_id) {
+        workers.emplace_back([&]{
+            MateSolver solver(std::max<std::size_t>(table_size_mb / num_threads, 1));
+            Board      board;
+
+            for (std::size_t index = next_index++; index < positions.size(); index = next_index++) {
+                // entries are exact positions, so the table is kept between positions
+                board.set_fen(std::string(positions[index].fen));
+                results[index] = solver.solve(board, positions[index].mate_in_n);
+            }
+        });
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    const auto time_spent = (current_time() - start_time).count();
+
+    // report failures and summary
+    std::size_t solved      = 0;
+    uint64_t    total_nodes = 0;
+    for (std::size_t index = 0; index < positions.size(); ++index) {
+        const MateResult& result = results[index];
+        total_nodes += result.nodes;
+
+        if (result.proven && result.mate_in_n == positions[index].mate_in_n) {
+            ++solved;
+            continue;
+        }
+
+        std::cout << "info string position " << index + 1 << " \"" << positions[index].fen << "\" "
+                  << "expected mate " << positions[index].mate_in_n << " ";
+        if (result.proven) {std::cout << "found mate " << result.mate_in_n << "\n";}
+        else               {std::cout << "no mate found\n";}
+    }
+
+    const auto solves_per_second = (time_spent > 0) ? 1000. * solved      / time_spent : 0.;
+    const auto nodes_per_second  = (time_spent > 0) ? 1000. * total_nodes / time_spent : 0.;
+
+    std::cout << "positions "  << positions.size()                                  << "\n"
+              << "solved "     << solved                                            << "\n"
+              << "threads "    << num_threads                                       << "\n"
+              << "time "       << time_spent                                        << " ms\n"
+              << "nodes "      << total_nodes                                       << "\n"
+              << "solves/s "   << static_cast<unsigned long long>(solves_per_second) << "\n"
+              << "nps "        << static_cast<unsigned long long>(nodes_per_second)  << "\n"
+              << std::endl;
+}
+
+} // MPChess namespace
\ No newline at end of file
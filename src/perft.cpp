@@ -2,68 +2,398 @@
 
 #include "perft.hpp"
 
+#include "defs.hpp"     // types, constants
+#include "utils.hpp"    // current_time
+#include "board.hpp"    // board
 #include "movelist.hpp"
 #include "movegen.hpp"
 
+#include "uci.hpp"      // move_to_uci_notation
+
+#include <thread>       // thread
+#include <algorithm>    // max, sort, find_if
+#include <fstream>      // ifstream
+#include <sstream>      // stringstream
+#include <iostream>     // cout
+
 using namespace MPChess::Types;
+using namespace MPChess::Constants;
 
 
 namespace MPChess {
 
+// PerftTable
+
+PerftTable::PerftTable(std::size_t table_size_mb) :
+    table_size{std::max<std::size_t>((table_size_mb * 1024 * 1024) / sizeof(PerftEntry), 1)},
+    table(table_size)
+{
+
+}
+
+// the same position at a different depth is a different entry
+static Key depth_key(Key key, unsigned int depth) {
+    return key ^ (depth * 0x9E3779B97F4A7C15ull);
+}
+
+bool PerftTable::probe(Key key, unsigned int depth, unsigned long long& nodes) const {
+    key = depth_key(key, depth);
+    const PerftEntry& entry = this->table[key % this->table_size];
+
+    const uint64_t entry_check = entry.check.load(std::memory_order_relaxed);
+    const uint64_t entry_nodes = entry.nodes.load(std::memory_order_relaxed);
+
+    if ((entry_check ^ entry_nodes) != key) {return false;}
+
+    nodes = entry_nodes;
+    return true;
+}
+
+// always replace
+void PerftTable::store(Key key, unsigned int depth, unsigned long long nodes) {
+    key = depth_key(key, depth);
+    PerftEntry& entry = this->table[key % this->table_size];
+
+    entry.check.store(key ^ nodes, std::memory_order_relaxed);
+    entry.nodes.store(nodes,       std::memory_order_relaxed);
+}
+
+
+// perft
+
 unsigned long long perft(unsigned int depth, Board& board, PerftInfo* p_perft_info) {
 
+    if (depth == 0) {return 1ull;}
+
+    // legal moves only, no make/unmake needed to filter illegal moves
     RegularMoveList move_list;
-    generate_moves<MoveGenType::PSEUDOLEGAL>(board, move_list);
+    generate_moves<MoveGenType::LEGAL>(board, move_list);
 
-    if (depth == 0) {return 1ull;}
+    // bulk counting, every legal move is a leaf
+    if (depth == 1 && p_perft_info == nullptr) {return move_list.get_size();}
 
     unsigned long long node_count = 0;
     for (const auto& move : move_list) {
 
         board.make_move(move);
 
-        // check if legal move
-        if (!board.is_check<false>()) {
-
-            // save perft info if specified
-            if (p_perft_info != nullptr) {
+        // save perft info if specified
+        if (p_perft_info != nullptr) {
 
-                if (depth == 1) {
+            if (depth == 1) {
 
-                    // piece captured
-                    if (move.is_capture()) {
-                        ++(p_perft_info->captures);
-                    }
+                // piece captured
+                if (move.is_capture()) {
+                    ++(p_perft_info->captures);
+                }
 
-                    // enpassant
-                    if (move.is_enpassant()) {
-                        ++(p_perft_info->enpassants);
-                    }
+                // enpassant
+                if (move.is_enpassant()) {
+                    ++(p_perft_info->enpassants);
+                }
 
-                    // castle
-                    if (move.is_castle()) {
-                        ++(p_perft_info->castles);
-                    }
+                // castle
+                if (move.is_castle()) {
+                    ++(p_perft_info->castles);
+                }
 
-                    // promotion
-                    if (move.is_promote()) {
-                        ++(p_perft_info->promotions);
-                    }
+                // promotion
+                if (move.is_promote()) {
+                    ++(p_perft_info->promotions);
+                }
 
-                    // checks
-                    if (board.is_check<true>()) {
-                        ++(p_perft_info->checks);
-                    }
+                // checks
+                if (board.is_check<true>()) {
+                    ++(p_perft_info->checks);
                 }
             }
-        
-            node_count += perft(depth - 1, board, p_perft_info);
         }
 
+        node_count += perft(depth - 1, board, p_perft_info);
+
         board.unmake_move();
     }
 
     return node_count;
 }
 
+unsigned long long perft(unsigned int depth, Board& board, PerftTable& table) {
+
+    if (depth == 0) {return 1ull;}
+
+    // depth 1 is cheaper to count than to probe
+    unsigned long long node_count = 0;
+    if (depth > 1 && table.probe(board.get_zobrist_key(), depth, node_count)) {
+        return node_count;
+    }
+
+    RegularMoveList move_list;
+    generate_moves<MoveGenType::LEGAL>(board, move_list);
+
+    // bulk counting
+    if (depth == 1) {return move_list.get_size();}
+
+    for (const auto& move : move_list) {
+        board.make_move(move);
+        node_count += perft(depth - 1, board, table);
+        board.unmake_move();
+    }
+
+    table.store(board.get_zobrist_key(), depth, node_count);
+
+    return node_count;
+}
+
+
+// multi-threaded perft
+
+// a task is the subtree after a root move (and a reply)
+struct PerftTask {
+    std::size_t root_index;
+    Move        reply;
+};
+
+PerftResult parallel_perft(const Board& board, unsigned int depth, std::size_t num_threads, std::size_t table_size_mb) {
+
+    const auto start_time = current_time();
+
+    PerftResult result;
+    if (depth == 0) {
+        result.nodes = 1;
+        return result;
+    }
+
+    // split the tree at the root replies from depth 3
+    // (20-50 root moves are too few to balance uneven subtrees over threads)
+    RegularMoveList        root_moves;
+    std::vector<PerftTask> tasks;
+    {
+        Board split_board{board};
+        generate_moves<MoveGenType::LEGAL>(split_board, root_moves);
+
+        for (std::size_t root_index = 0; root_index < root_moves.get_size(); ++root_index) {
+            if (depth < 3) {
+                tasks.push_back({root_index, Move{}});
+                continue;
+            }
+
+            split_board.make_move(root_moves[root_index]);
+
+            RegularMoveList replies;
+            generate_moves<MoveGenType::LEGAL>(split_board, replies);
+            for (const Move& reply : replies) {
+                tasks.push_back({root_index, reply});
+            }
+
+            split_board.unmake_move();
+        }
+    }
+
+    num_threads = std::max<std::size_t>(num_threads, 1);
+
+    PerftTable table(table_size_mb);
+
+    std::atomic<std::size_t>                     next_index = 0;
+    std::vector<std::atomic<unsigned long long>> root_nodes(root_moves.get_size());
+
+    std::vector<std::thread> workers;
+    for (std::size_t thread_id = 0; thread_id < num_threads; ++thread_id) {
+        workers.emplace_back([&]{
+            Board thread_board;
+
+            for (std::size_t index = next_index++; index < tasks.size(); index = next_index++) {
+                const PerftTask& task = tasks[index];
+
+                board.clone_into(thread_board);
+                thread_board.make_move(root_moves[task.root_index]);
+
+                if (task.reply.is_null()) {
+                    root_nodes[task.root_index] += perft(depth - 1, thread_board, table);
+                }
+                else {
+                    thread_board.make_move(task.reply);
+                    root_nodes[task.root_index] += perft(depth - 2, thread_board, table);
+                }
+            }
+        });
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    for (std::size_t root_index = 0; root_index < root_moves.get_size(); ++root_index) {
+        result.divide.push_back({root_moves[root_index], root_nodes[root_index]});
+        result.nodes += root_nodes[root_index];
+    }
+    result.time = current_time() - start_time;
+
+    return result;
+}
+
+std::ostream& operator<<(std::ostream& os, const PerftResult& result) {
+
+    for (const PerftDivide& root : result.divide) {
+        os << UCI::move_to_uci_notation(root.move) << ": " << root.nodes << "\n";
+    }
+    if (!result.divide.empty()) {os << "\n";}
+
+    const auto time_spent = result.time.count();
+
+    os << "nodes " << result.nodes << "\n"
+       << "time "  << time_spent   << " ms\n"
+       << "nps "   << ((time_spent > 0) ? 1000 * result.nodes / time_spent : 0) << "\n";
+
+    return os;
+}
+
+
+
+// perft suite
+
+struct PerftSuiteDepth {
+    unsigned int       depth;
+    unsigned long long expected_nodes;
+};
+
+struct PerftSuitePosition {
+    std::string                  fen;
+    std::vector<PerftSuiteDepth> depths;
+};
+
+struct PerftSuiteResult {
+    bool               run         = false;
+    bool               passed      = true;
+    unsigned int       depth       = 0; // deepest depth run, or the failing depth
+    unsigned long long nodes       = 0; // nodes at depth
+    unsigned long long total_nodes = 0; // nodes over all depths
+    Milliseconds       time{0};
+};
+
+bool perft_suite(const std::string& epd_path, std::size_t num_threads, std::size_t table_size_mb, unsigned int max_depth) {
+
+    // parse epd, "<fen> ;D1 <nodes> ;D2 <nodes> ..."
+    std::ifstream epd_file(epd_path);
+    if (!epd_file) {
+        std::cout << "info string cannot open " << epd_path << "\n";
+        return false;
+    }
+
+    std::vector<PerftSuitePosition> positions;
+    std::string line;
+    while (std::getline(epd_file, line)) {
+        std::istringstream stream(line);
+
+        PerftSuitePosition position;
+        if (!std::getline(stream, position.fen, ';')) {continue;}
+        while (!position.fen.empty() && position.fen.back() == ' ') {position.fen.pop_back();}
+
+        std::string operation;
+        while (std::getline(stream, operation, ';')) {
+            std::istringstream operation_stream(operation);
+
+            std::string        opcode;
+            unsigned long long expected_nodes;
+            if (operation_stream >> opcode >> expected_nodes && opcode.size() > 1 && opcode[0] == 'D') {
+                const unsigned int depth = std::stoul(opcode.substr(1));
+                if (depth <= max_depth) {position.depths.push_back({depth, expected_nodes});}
+            }
+        }
+
+        if (!position.fen.empty() && !position.depths.empty()) {
+            std::sort(position.depths.begin(), position.depths.end(),
+                      [](const PerftSuiteDepth& a, const PerftSuiteDepth& b) {return a.depth < b.depth;});
+            positions.push_back(std::move(position));
+        }
+    }
+
+    num_threads = std::max<std::size_t>(num_threads, 1);
+
+    std::vector<PerftSuiteResult> results(positions.size());
+    std::atomic<std::size_t> next_index = 0;
+    std::atomic<bool>        failed     = false;
+
+    const auto start_time = current_time();
+
+    std::vector<std::thread> workers;
+    for (std::size_t thread_id = 0; thread_id < num_threads; ++thread_id) {
+        workers.emplace_back([&]{
+            PerftTable table(std::max<std::size_t>(table_size_mb / num_threads, 1));
+            Board      board;
+
+            for (std::size_t index = next_index++; index < positions.size() && !failed; index = next_index++) {
+                PerftSuiteResult& result = results[index];
+                result.run = true;
+
+                // shallow depths first, so a failure is reported at the smallest tree
+                const auto position_start_time = current_time();
+                for (const PerftSuiteDepth& expected : positions[index].depths) {
+                    board.set_fen(std::string(positions[index].fen));
+
+                    result.depth        = expected.depth;
+                    result.nodes        = perft(expected.depth, board, table);
+                    result.total_nodes += result.nodes;
+
+                    if (result.nodes != expected.expected_nodes) {
+                        result.passed = false;
+                        failed        = true;
+                        break;
+                    }
+                }
+                result.time = current_time() - position_start_time;
+            }
+        });
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    const auto time_spent = (current_time() - start_time).count();
+
+    // per position report
+    std::size_t        passed      = 0;
+    unsigned long long total_nodes = 0;
+    for (std::size_t index = 0; index < positions.size(); ++index) {
+        const PerftSuiteResult& result = results[index];
+        if (!result.run) {continue;}
+
+        total_nodes += result.total_nodes;
+        passed      += result.passed;
+
+        const auto position_time = result.time.count();
+        std::cout << "position " << index + 1
+                  << " depth "   << result.depth
+                  << " nodes "   << result.nodes
+                  << " time "    << position_time << " ms"
+                  << " nps "     << ((position_time > 0) ? 1000 * result.total_nodes / position_time : 0)
+                  << (result.passed ? " ok" : " FAILED") << "\n";
+    }
+
+    // divide of the failing positions
+    for (std::size_t index = 0; index < positions.size(); ++index) {
+        const PerftSuiteResult& result = results[index];
+        if (!result.run || result.passed) {continue;}
+
+        const auto expected = std::find_if(positions[index].depths.begin(), positions[index].depths.end(),
+                                           [&](const PerftSuiteDepth& depth) {return depth.depth == result.depth;});
+
+        std::cout << "\n"
+                  << "info string position " << index + 1 << " \"" << positions[index].fen << "\" "
+                  << "depth " << result.depth << " expected " << expected->expected_nodes << " found " << result.nodes << "\n"
+                  << parallel_perft(Board{std::string(positions[index].fen)}, result.depth, num_threads, table_size_mb);
+    }
+
+    std::cout << "\n"
+              << "positions " << positions.size() << "\n"
+              << "passed "    << passed           << "\n"
+              << "threads "   << num_threads      << "\n"
+              << "time "      << time_spent       << " ms\n"
+              << "nodes "     << total_nodes      << "\n"
+              << "nps "       << ((time_spent > 0) ? 1000 * total_nodes / time_spent : 0) << "\n"
+              << std::endl;
+
+    return !failed;
+}
+
 } // MPChess namespace
\ No newline at end of file
@@ -11,11 +11,13 @@
 
 #include "evaluation.hpp"  // evaluate
 #include "movepicker.hpp"  // movepicker
+#include "matesearch.hpp"  // mate solver
 
 #include "uci.hpp"         // uci
 
 #include <cmath>           // pow
 #include <algorithm>       // find, sort
+#include <limits>          // numeric_limits
 
 using namespace MPChess::Types;
 using namespace MPChess::Constants;
@@ -23,39 +25,139 @@ using namespace MPChess::Constants;
 
 namespace MPChess {
 
+// update quiet move ordering heuristics after a quiet beta cutoff
+// best move gets a bonus, quiets searched before it get a malus
+static void update_quiet_heuristics(HeuristicTables&       heuristics,
+                                    const Board&           board,
+                                    Move                   best_move,
+                                    const RegularMoveList& quiets_searched,
+                                    Depth                  depth)
+{
+    const int bonus = history_bonus(depth);
+
+    // continuation tables of previous moves
+    std::array<HistoryTable*, CONTINUATION_PLIES.size()> continuation_tables{};
+    for (std::size_t cont_ind = 0; cont_ind < CONTINUATION_PLIES.size(); ++cont_ind) {
+        const Move  prev_move  = board.get_previous_move(CONTINUATION_PLIES[cont_ind]);
+        const Piece prev_piece = board.get_previous_moved_piece(CONTINUATION_PLIES[cont_ind]);
+
+        // no previous move (root or null move)
+        if (prev_move.is_null()) {continue;}
+
+        continuation_tables[cont_ind] = &(heuristics.continuation_history[prev_piece][prev_move.get_to_square()]);
+
+        // counter move
+        if (CONTINUATION_PLIES[cont_ind] == 1) {
+            heuristics.counter_moves[prev_piece][prev_move.get_to_square()] = best_move;
+        }
+    }
+
+    auto update_move = [&](Move move, int move_bonus) {
+        const Piece  p  = board.moved_piece(move);
+        const Square to = move.get_to_square();
+
+        update_history(heuristics.history[p][to], move_bonus);
+        for (HistoryTable* p_continuation_table : continuation_tables) {
+            if (p_continuation_table != nullptr) {
+                update_history((*p_continuation_table)[p][to], move_bonus);
+            }
+        }
+    };
+
+    update_move(best_move, bonus);
+    for (const Move& move : quiets_searched) {
+        if (move != best_move) {
+            update_move(move, -bonus);
+        }
+    }
+}
+
+// update capture history after a beta cutoff
+// cutoff capture gets a bonus, captures searched before it get a malus
+// (best move may be quiet, then only the malus is applied)
+static void update_capture_heuristics(HeuristicTables&       heuristics,
+                                      const Board&           board,
+                                      Move                   best_move,
+                                      const RegularMoveList& captures_searched,
+                                      Depth                  depth)
+{
+    const int bonus = history_bonus(depth);
+
+    auto update_move = [&](Move move, int move_bonus) {
+        const Piece     p        = board.moved_piece(move);
+        const Square    to       = move.get_to_square();
+        const PieceType captured = piece_type(board.captured_piece(move));
+
+        update_history(heuristics.capture_history[p][to][captured], move_bonus);
+    };
+
+    if (best_move.is_capture()) {
+        update_move(best_move, bonus);
+    }
+    for (const Move& move : captures_searched) {
+        if (move != best_move) {
+            update_move(move, -bonus);
+        }
+    }
+}
+
 Eval quiescence(EngineThread& thread,
                 Eval          alpha,
-                Eval          beta)
+                Eval          beta,
+                std::size_t   ply,
+                std::size_t   qs_ply)
 {
-    if (thread.status == EngineThreadStatus::IDLE) {return 0;}
+    if (!Engine::thread_pool.is_running()) {return 0;}
 
-    Board& board = thread.root_board;    
+    Board&            board      = thread.root_board;    
+    HeuristicTables&  heuristics = thread.data->heuristics;
 
-    Eval stand_pat = evaluate(board);
-    if (stand_pat >= beta)  {return beta;}
-    if (stand_pat >  alpha) {alpha = stand_pat;}
+    // check max search ply
+    if (ply >= MAX_SEARCH_PLY) {return evaluate(board);}
+
+    // no stand pat in check, all evasions are searched
+    const bool in_check = board.is_check<true>();
+    if (!in_check) {
+        Eval stand_pat = evaluate(board);
+        if (stand_pat >= beta)  {return beta;}
+        if (stand_pat >  alpha) {alpha = stand_pat;}
+    }
 
-    // RegularMoveList pseudo_legal_captures;
-    // generate_moves<MoveGenType::CAPTURE>(board, pseudo_legal_captures);
-    MovePicker<MoveGenType::CAPTURE> move_picker(board);
-    Move capture;
-    while (!(capture = move_picker.next_move()).is_null()) {
+    // captures (and quiet checks on the first quiescence ply), or evasions in check
+    MovePicker<MoveGenType::CAPTURE> move_picker(board, heuristics, thread.data->stack[ply].killers, qs_ply == 0);
+    Move move;
+    std::size_t legal_count = 0;
+    RegularMoveList captures_searched;
+    while (!(move = move_picker.next_move()).is_null()) {
 
         // make move
-        board.make_move(capture);
+        board.make_move(move);
 
-        // if illegal
-        if (board.is_check<false>()) {
+        // if illegal (evasions are legal)
+        if (!in_check && board.is_check<false>()) {
             board.unmake_move();
             continue;
         }
 
-        ++(thread.node_counter);
+        ++legal_count;
+        thread.count_node();
 
-        const Eval score = -quiescence(thread, -beta, -alpha);
+        const Eval score = -quiescence(thread, -beta, -alpha, ply + 1, qs_ply + 1);
         board.unmake_move();
 
+        if (move.is_capture()) {
+            captures_searched.add_move(move);
+        }
+
         if (score >= beta)  {
+
+            // cutoff stats
+            ++(thread.cutoff_counter);
+            if (legal_count == 1) {++(thread.first_move_cutoff_counter);}
+
+            // capture history (qsearch cutoffs are scored as depth 1)
+            update_capture_heuristics(heuristics, board, move, captures_searched, 1);
+
             return beta;
         }
         
@@ -64,32 +166,59 @@ Eval quiescence(EngineThread& thread,
         }
     }
 
+    // checkmate
+    if (in_check && legal_count == 0) {
+        return mated_in(ply);
+    }
+
     return alpha;
 }
 
-Eval alpha_beta(EngineThread&    thread,
-                Depth            depth,
-                Eval             alpha,
-                Eval             beta,
-                bool             root,
-                RegularMoveList& pv_parent)
+Eval alpha_beta(EngineThread& thread,
+                Depth         depth,
+                Eval          alpha,
+                Eval          beta,
+                std::size_t   ply)
 {
-    Board&              board = thread.root_board;
-    TranspositionTable& tt    = Engine::tt;
-
-    // check max_ply or repetition
-    if (board.get_ply_played() >= MAX_PLY)                    {return evaluate(board);}
-    if (board.is_repetition() || board.get_ply_clock() > 100) {return 0;}
+    Board&              board      = thread.root_board;
+    TranspositionTable& tt         = Engine::tt;
+    HeuristicTables&    heuristics = thread.data->heuristics;
+    SearchStack&        stack      = thread.data->stack;
+
+    const bool root = (ply == 0);
+
+    // reset pv of this ply (parent reads it after this node returns)
+    RegularMoveList& pv = stack[ply].pv;
+    pv.shrink(0);
+
+    // check max search ply or repetition (the root is searched even if it repeats the game)
+    if (ply >= MAX_SEARCH_PLY)                                            {return evaluate(board);}
+    if (!root && (board.is_repetition() || board.get_ply_clock() > 100)) {return 0;}
+
+    // check for stop signal (limits are checked as nodes are counted)
+    if (!Engine::thread_pool.is_running()) {return 0;}
+
+    // mate distance pruning
+    // no line from here can beat mating at the next ply or be worse than being mated now
+    if (!root) {
+        alpha = std::max(alpha, mated_in(ply));
+        beta  = std::min(beta,  mate_in(ply + 1));
+        if (alpha >= beta) {return alpha;}
+    }
 
-    // check for stop signal
-    if (thread.is_main_thread() && thread.check_stop()) {return 0;}
-    if (thread.status == EngineThreadStatus::IDLE)      {return 0;}
+    // upcoming repetition
+    // the side to move can repeat a position (a draw), so the score is at least a draw
+    if (!root && alpha < 0 && board.has_upcoming_repetition(ply)) {
+        alpha = 0;
+        if (alpha >= beta) {return alpha;}
+    }
 
     // probe hash entry
+    // (not at root, the root pv has to come from the search)
     const TTEntry   tt_entry     = tt.probe(board.get_zobrist_key());
-    const Eval&     tt_eval      = tt_entry.eval;
+    const Eval      tt_eval      = score_from_tt(tt_entry.eval, ply);
     const NodeType& tt_node_type = tt_entry.node;
-    if (!tt_entry.is_null() && tt_entry.depth >= depth) {
+    if (!root && !tt_entry.is_null() && tt_entry.depth >= depth) {
         if (tt_node_type == NodeType::PV_NODE
             || (tt_node_type == NodeType::ALL_NODE && tt_eval <= alpha)
             || (tt_node_type == NodeType::CUT_NODE && tt_eval >= beta))
@@ -100,14 +229,13 @@ Eval alpha_beta(EngineThread&    thread,
 
     // quiescence
     if (depth == 0) {
-        return quiescence(thread, alpha, beta);
+        return quiescence(thread, alpha, beta, ply, 0);
     }
 
     // alpha-beta
     Move            best_move;
     Eval            best_score = -Evals::INF;
     NodeType        node_type  =  NodeType::ALL_NODE;
-    RegularMoveList pv_child;
 
     const bool in_check = board.is_check<true>();
 
@@ -116,16 +244,38 @@ Eval alpha_beta(EngineThread&    thread,
     if (depth >= R + 2 && !in_check) {
 
         board.make_null_move();
-        Eval score = -alpha_beta(thread, depth - 1 - R, -beta, -beta + 1, false, pv_child); // TODO : no need for pv here
+        Eval score = -alpha_beta(thread, depth - 1 - R, -beta, -beta + 1, ply + 1);
         board.unmake_null_move();
 
         if (score >= beta) {return beta;}
     }
 
-    MovePicker<MoveGenType::PSEUDOLEGAL> move_picker(board);
+    // abdada, moves into positions other threads are searching are deferred until the other moves are searched
+    const bool abdada = !root
+                     && Engine::options.abdada
+                     && Engine::thread_pool.get_num_threads() > 1
+                     && depth >= ABDADA_MIN_DEPTH;
+
+    MovePicker<MoveGenType::LEGAL> move_picker(board, heuristics, stack[ply].killers);
+
+    RegularMoveList deferred_moves;
+    std::size_t     deferred_ind = 0;
+    bool            picker_done  = false;
+    auto next_move = [&]() -> Move {
+        if (!picker_done) {
+            const Move picked_move = move_picker.next_move();
+            if (!picked_move.is_null()) {return picked_move;}
+            picker_done = true;
+        }
+        return (deferred_ind < deferred_moves.get_size()) ? deferred_moves[deferred_ind++] : Move{};
+    };
+
+    const CheckInfo check_info = board.get_check_info();
     Move move;
     std::size_t legal_count = 0;
-    while (!(move = move_picker.next_move()).is_null()) {
+    RegularMoveList quiets_searched;
+    RegularMoveList captures_searched;
+    while (!(move = next_move()).is_null()) {
 
         // root moves
         if (root &&
@@ -137,29 +287,38 @@ Eval alpha_beta(EngineThread&    thread,
             continue;
         } 
 
-        // make move
+        // check if move gives check (before make move)
+        const bool gives_check = board.gives_check(move, check_info);
+
+        // make move (moves are legal)
         board.make_move(move);
 
-        // if illegal
-        if (board.is_check<false>()) {
+        // abdada, defer the move if another thread is searching its position (never the first move)
+        const Key child_key = board.get_zobrist_key();
+        if (abdada && legal_count > 0 && !picker_done && Engine::abdada_table.is_searching(child_key)) {
             board.unmake_move();
+            deferred_moves.add_move(move);
             continue;
         }
+
         ++legal_count;
-        ++(thread.node_counter);
+        thread.count_node();
         if (root && thread.is_main_thread()) {++(Engine::search_info.curr_move_number);}
 
         // check if move is a killer move
-        const auto p_kmove = std::find(Engine::killer_table[depth].begin(), Engine::killer_table[depth].end(), move);
-        const bool is_killer_move = (p_kmove != Engine::killer_table[depth].end());
+        const bool is_killer_move = stack[ply].is_killer(move);
 
         // uci update
         if (thread.is_main_thread()
             && depth == 1
             && (current_time() - Engine::prev_uci_update_time) > Engine::uci_update_frequency)
         {
-            Engine::prev_uci_update_time        = current_time();
-            const RegularMoveList& played_moves = board.get_move_list();
+            Engine::prev_uci_update_time = current_time();
+
+            RegularMoveList played_moves;
+            for (std::size_t plies_ago = board.get_ply_played(); plies_ago > 0; --plies_ago) {
+                played_moves.add_move(board.get_previous_move(plies_ago));
+            }
 
             // Only print update if not in null pruning variation
             // TODO : is this null prune variation check slow?
@@ -178,42 +337,55 @@ Eval alpha_beta(EngineThread&    thread,
             }
         }
 
+        if (abdada) {Engine::abdada_table.start_search(child_key);}
+
         // late move reductions
         Eval score;
         const std::size_t R = depth / 3; // reduction size
         if (legal_count > 4         &&   // search at least 4 moves first
             !move.is_capture()      &&   // do not reduce captures
-            !board.is_check<true>() &&   // do not reduce moves that give check
+            !gives_check            &&   // do not reduce moves that give check
             !in_check               &&   // do not reduce moves while in check
             !is_killer_move)             // do not reduce killer moves   
         {
-            score = -alpha_beta(thread, depth - R - 1, -beta, -alpha, false, pv_child);
+            score = -alpha_beta(thread, depth - R - 1, -beta, -alpha, ply + 1);
         }
         else {
 
             std::size_t E = 0; // extension size
-            if (board.is_check<true>()) {E += 1;} // check extension
+            if (gives_check) {E += 1;} // check extension
             
-            score = -alpha_beta(thread, depth - 1 + E, -beta, -alpha, false, pv_child);
+            score = -alpha_beta(thread, depth - 1 + E, -beta, -alpha, ply + 1);
         }
 
+        if (abdada) {Engine::abdada_table.finish_search(child_key);}
+
 
         board.unmake_move();
 
+        if (!move.is_capture()) {quiets_searched.add_move(move);}
+        else                    {captures_searched.add_move(move);}
+
         if (score >= beta) {
 
             // store cutoff move in tt
             node_type = NodeType::CUT_NODE;
-            tt.store(board.get_zobrist_key(), move, beta, depth, node_type);
+            tt.store(board.get_zobrist_key(), move, score_to_tt(beta, ply), depth, node_type);
+
+            // cutoff stats
+            ++(thread.cutoff_counter);
+            if (legal_count == 1) {++(thread.first_move_cutoff_counter);}
+
+            // capture history
+            update_capture_heuristics(heuristics, board, move, captures_searched, depth);
 
-            // killer move
             if (!move.is_capture()) {
-                if (!is_killer_move) {
-                    for (std::size_t k_ind = NUM_KILLER_MOVES-1; k_ind > 0; --k_ind) {
-                        Engine::killer_table[depth][k_ind] = Engine::killer_table[depth][k_ind-1];
-                    }
-                    Engine::killer_table[depth][0] = move;
-                }
+
+                // history, counter move, and continuation history
+                update_quiet_heuristics(heuristics, board, move, quiets_searched, depth);
+
+                // killer move (of this search ply)
+                stack[ply].add_killer(move);
             }
             return beta;
         }
@@ -222,14 +394,9 @@ Eval alpha_beta(EngineThread&    thread,
             node_type = NodeType::PV_NODE;
 
             // update pv
-            pv_parent.shrink(0);
-            pv_parent.add_move(move);
-            pv_parent.add_moves(pv_child);
-
-            // history move
-            if (!move.is_capture()) {
-                Engine::history_table[board.moved_piece(move)][move.get_to_square()] += (depth * depth);
-            }
+            pv.shrink(0);
+            pv.add_move(move);
+            pv.add_moves(stack[ply + 1].pv);
         }
 
         if (score > best_score) {
@@ -242,8 +409,8 @@ Eval alpha_beta(EngineThread&    thread,
     if (legal_count == 0) {
         
         // checkmate
-        if (board.is_check<true>()) {
-            return -Evals::MATE + board.get_ply_played();
+        if (in_check) {
+            return mated_in(ply);
         }
         // stalemate
         else {
@@ -251,100 +418,179 @@ Eval alpha_beta(EngineThread&    thread,
         }
     }
 
-    tt.store(board.get_zobrist_key(), best_move, best_score, depth, node_type);
+    tt.store(board.get_zobrist_key(), best_move, score_to_tt(best_score, ply), depth, node_type);
     return alpha;
 }
 
+// info line of a pv (multipv index is not printed if NO_MULTIPV)
+static constexpr std::size_t NO_MULTIPV = std::numeric_limits<std::size_t>::max();
+
+static void print_pv_info(const PVLine&      pv_line,
+                          Depth              depth,
+                          std::size_t        pv_ind,
+                          uint64_t           total_nodes,
+                          unsigned long long nodes_per_second)
+{
+    std::cout << "info "
+              << "depth " << depth << " ";
+
+    if (pv_ind != NO_MULTIPV) {
+        std::cout << "multipv " << pv_ind << " ";
+    }
+
+    const Eval pv_score = pv_line.get_score();
+    if (is_mate_score(pv_score)) {
+        std::cout << "score mate " << mate_in_moves(pv_score) << " ";
+    }
+    else {
+        std::cout << "score cp "   << pv_score                << " ";
+    }
+
+    std::cout << "nodes " << total_nodes      << " "
+              << "nps "   << nodes_per_second << " "
+              << "pv ";
+
+    for (const Move& pv_move : pv_line) {
+        std::cout << UCI::move_to_uci_notation(pv_move) << " ";
+    }
+    std::cout << "\n";
+}
+
 Eval search(EngineThread& thread) {
 
     // copy engine position to each thread
-    Board&           root_board = thread.root_board;
-    RegularMoveList& root_moves = thread.root_moves;
-    root_board.set_fen(Engine::engine_board.get_fen());
+    Board&                 root_board = thread.root_board;
+    RegularMoveList&       root_moves = thread.root_moves;
+    std::vector<PVLine>&   pv_lines   = thread.pv_lines;
+    const RegularMoveList& root_pv    = thread.data->stack[0].pv;
+    Engine::engine_board.clone_into(root_board);
+    pv_lines.assign(Engine::options.num_pvs, PVLine{});
+
+    // killers are only meaningful for positions of the previous search
+    for (SearchStackEntry& entry : thread.data->stack) {
+        entry.reset();
+    }
+
+    // mate search (go mate n), try the df-pn mate solver first
+    // falls back to alpha-beta if no mate is proven in time
+    if (Engine::search_info.mate_in_n > 0 && thread.is_main_thread()) {
+        const MateResult result = Engine::mate_solver.solve(root_board, Engine::search_info.mate_in_n, [&thread]{
+            return thread.check_stop() || !Engine::thread_pool.is_running();
+        });
+
+        // the pv is followed through the table and can be empty if entries were replaced,
+        // then there is no move to report and alpha-beta finds the mate instead
+        if (result.proven && result.pv.get_size() != 0) {
+            const auto time_spent       = (current_time() - Engine::search_info.start_time).count();
+            const auto nodes_per_second = (time_spent > 0) ? static_cast<unsigned long long>(1000. * result.nodes / time_spent) : 0ull;
+
+            std::cout << "info "
+                      << "depth "      << 2 * result.mate_in_n - 1 << " "
+                      << "score mate " << result.mate_in_n         << " "
+                      << "nodes "      << result.nodes             << " "
+                      << "nps "        << nodes_per_second         << " "
+                      << "pv ";
+            for (const Move& pv_move : result.pv) {
+                std::cout << UCI::move_to_uci_notation(pv_move) << " ";
+            }
+            std::cout << "\n";
+
+            Engine::thread_pool.signal_stop();
+            std::cout << "bestmove " << UCI::move_to_uci_notation(result.pv[0]) << "\n" << std::flush;
+            return mate_in(2 * result.mate_in_n - 1);
+        }
+    }
 
     // iterative deepening loop
     Depth depth   = 1;
     Eval  alpha   = -Evals::INF;
     Eval  beta    =  Evals::INF;
     Eval  window  =  Constants::PAWN_SCORE / 2;
+    thread.completed_depth = 0;
     while (Engine::thread_pool.is_running()
-           && depth < MAX_PLY)
-    {                                              
+           && depth < static_cast<Depth>(MAX_SEARCH_PLY)
+           && depth <= static_cast<Depth>(Engine::search_info.max_depth))
+    {
+        // lazy smp, helper threads skip depths (so threads search different depths at the same time)
+        // with abdada all threads search the same depth and divide its moves instead
+        if (!thread.is_main_thread() && !Engine::options.abdada) {
+            const std::size_t skip_ind = (thread.id - 1) % SMP_SKIP_SIZES.size();
+            if (((depth + root_board.get_ply_played() + SMP_SKIP_PHASES[skip_ind]) / SMP_SKIP_SIZES[skip_ind]) % 2) {
+                ++depth;
+                continue;
+            }
+        }
+
         // root moves
         if (Engine::search_info.root_moves.get_size() > 0) {
             root_moves = Engine::search_info.root_moves;
         }
         else {
             root_moves.shrink(0);
-            generate_moves<MoveGenType::PSEUDOLEGAL>(root_board, root_moves);
+            generate_moves<MoveGenType::LEGAL>(root_board, root_moves);
         }
 
         // multipv loop
-        RegularMoveList  temp_pv_line;
+        bool             stopped = false;
         std::size_t      num_pvs = std::min(root_moves.get_size(), Engine::options.num_pvs);
         for (std::size_t pv_ind  = 0; pv_ind < num_pvs; ++pv_ind) {
 
-            // reset pv and search stats
-            temp_pv_line.shrink(0);
-            Engine::search_info.curr_move_number      = 0;
-            Engine::search_info.depth_node_count_prev = Engine::search_info.depth_node_count;
-            Engine::search_info.depth_node_count      = 0;
-            
-            Eval score = alpha_beta(thread, depth, alpha, beta, true, temp_pv_line);
+            // reset search stats (reported by the main thread)
+            if (thread.is_main_thread()) {
+                Engine::search_info.curr_move_number      = 0;
+                Engine::search_info.depth_node_count_prev = Engine::search_info.depth_node_count;
+                Engine::search_info.depth_node_count      = 0;
+            }
+
+            Eval score = alpha_beta(thread, depth, alpha, beta, 0);
 
             // adjust aspiration window
             if (score <= alpha || score >= beta) {
                 alpha = -Evals::INF;
                 beta  =  Evals::INF;
 
-                temp_pv_line.shrink(0);
-                score = alpha_beta(thread, depth, alpha, beta, true, temp_pv_line);
+                score = alpha_beta(thread, depth, alpha, beta, 0);
             }
             else {
                 alpha = score - window;
                 beta  = score + window;
             }
 
-            if (Engine::thread_pool.is_running() && temp_pv_line.get_size() != 0)
+            if (Engine::thread_pool.is_running() && root_pv.get_size() != 0)
             {
-                Engine::pv_lines[pv_ind].set_moves(temp_pv_line);
-                Engine::pv_lines[pv_ind].set_score(score); 
+                pv_lines[pv_ind].set_moves(root_pv);
+                pv_lines[pv_ind].set_score(score); 
             }
             // ran out of time
             else {
+                stopped = true;
                 break;
             }
 
             // remove pv move from root moves and search another pv line
-            root_moves.remove_move(Engine::pv_lines[pv_ind][0]);            
+            root_moves.remove_move(pv_lines[pv_ind][0]);            
         } // pv loop
 
         // sort pvlines
-        std::sort(Engine::pv_lines.rbegin(), Engine::pv_lines.rend());
+        std::sort(pv_lines.rbegin(), pv_lines.rend());
 
-        // uci update
-        if (thread.is_main_thread() && temp_pv_line.get_size() != 0) {
-            const auto total_nodes      = Engine::thread_pool.sum_threads(&EngineThread::node_counter);
-            const auto time_spent       = (current_time() - Engine::search_info.start_time).count();
-            const auto nodes_per_second = static_cast<unsigned long long>(1000. * total_nodes / time_spent);
+        if (!stopped) {
+            thread.completed_depth = depth;
+        }
 
-            for (std::size_t pv_ind=0; pv_ind<num_pvs; ++pv_ind) {
-                std::cout << "info "
-                          << "depth " << depth << " ";
+        // uci update
+        if (thread.is_main_thread() && pv_lines[0].get_size() != 0) {
+            thread.publish_node_counter();
 
-                if (num_pvs > 1) {
-                    std::cout << "multipv " << pv_ind << " ";
-                }
+            const auto total_nodes      = Engine::thread_pool.sum_threads(&EngineThread::get_node_counter);
+            const auto time_spent       = (current_time() - Engine::search_info.start_time).count();
+            const auto nodes_per_second = (time_spent > 0) ? static_cast<unsigned long long>(1000. * total_nodes / time_spent) : 0ull;
 
-                std::cout << "score cp " << Engine::pv_lines[pv_ind].get_score() << " "
-                          << "nodes "    << total_nodes                          << " "
-                          << "nps "      << nodes_per_second                     << " "
-                          << "pv ";
+            // total since the search started (branching factors compare the totals of consecutive depths)
+            Engine::search_info.depth_node_count = total_nodes;
 
-                for (const Move& pv_move : Engine::pv_lines[pv_ind]) {
-                    std::cout << UCI::move_to_uci_notation(pv_move) << " ";
-                }
-                std::cout << "\n";
+            for (std::size_t pv_ind=0; pv_ind<num_pvs; ++pv_ind) {
+                print_pv_info(pv_lines[pv_ind], depth, (num_pvs > 1) ? pv_ind : NO_MULTIPV, total_nodes, nodes_per_second);
 
                 if (Engine::options.debug) {
                     std::cout << "info debug ";
@@ -353,21 +599,55 @@ Eval search(EngineThread& thread) {
                         // mean branching factor
                         const auto eff_bf   = 1.0 * Engine::search_info.depth_node_count / Engine::search_info.depth_node_count_prev;
                         const auto mean_bf  = std::pow(Engine::search_info.depth_node_count, 1. / depth);
-                        std::cout << "EBF: " << eff_bf << " MBF: " << mean_bf << "\n";
+                        std::cout << "EBF: " << eff_bf << " MBF: " << mean_bf << " ";
+                    }
+
+                    // first move cutoff rate (move ordering quality)
+                    if (thread.cutoff_counter > 0) {
+                        const auto fmc_rate = 100.0 * thread.first_move_cutoff_counter / thread.cutoff_counter;
+                        std::cout << "FMC: " << fmc_rate << "%";
                     }
+                    std::cout << "\n";
                 }
                 std::cout << std::endl;
             }
         }
 
+        // mate search, stop once a mate in at most mate_in_n moves is proven
+        if (Engine::search_info.mate_in_n > 0
+            && pv_lines[0].get_size() != 0
+            && pv_lines[0].get_score() >= mate_in(2 * Engine::search_info.mate_in_n - 1))
+        {
+            break;
+        }
+
         // iterative deepening depth increment
         ++depth;
     } // iterative deepening loop
 
     if (thread.is_main_thread()) {
-        std::cout << "bestmove " << UCI::move_to_uci_notation(Engine::pv_lines[0][0]) << "\n" << std::flush;
+        // search finished on its own (depth limit), stop helper threads
+        Engine::thread_pool.signal_stop();
+
+        // lazy smp, once the helpers are done the best thread is voted (only the main thread reports)
+        // its pv is reported if it is not the main thread's
+        Engine::thread_pool.wait_for_helpers();
+
+        const EngineThread& best_thread = (Engine::options.num_pvs == 1) ? Engine::thread_pool.best_thread() : thread;
+        if (&best_thread != &thread) {
+            const auto total_nodes      = Engine::thread_pool.sum_threads(&EngineThread::get_node_counter);
+            const auto time_spent       = (current_time() - Engine::search_info.start_time).count();
+            const auto nodes_per_second = (time_spent > 0) ? static_cast<unsigned long long>(1000. * total_nodes / time_spent) : 0ull;
+
+            print_pv_info(best_thread.get_pv_line(), best_thread.get_completed_depth(), NO_MULTIPV, total_nodes, nodes_per_second);
+            std::cout << std::flush;
+        }
+
+        const PVLine& best_pv   = best_thread.get_pv_line();
+        const Move    best_move = (best_pv.get_size() != 0) ? best_pv[0] : Move{};
+        std::cout << "bestmove " << UCI::move_to_uci_notation(best_move) << "\n" << std::flush;
     }
-    return Engine::pv_lines[0].get_score();
+    return pv_lines[0].get_score();
 }
 
 } // MPChess namespace
\ No newline at end of file
@@ -9,6 +9,10 @@
 
 #include "engine.hpp"      // engine globals
 
+#include <algorithm>       // max, min
+#include <iterator>        // next
+#include <utility>         // pair
+
 
 using namespace MPChess::Types;
 using namespace MPChess::Constants;
@@ -16,11 +20,26 @@ using namespace MPChess::Constants;
 
 namespace MPChess {
 
+// ThreadData
+
+void ThreadData::reset() {
+    this->heuristics.reset();
+
+    for (SearchStackEntry& entry : this->stack) {
+        entry.reset();
+    }
+}
+
+
 // EngineThread
 
+// thread data is allocated uninitialized and the first job is to clear it,
+// so its memory is first touched by the thread that uses it
 EngineThread::EngineThread(std::size_t id) :
     id{id},
-    status{Types::EngineThreadStatus::IDLE},
+    status{Types::EngineThreadStatus::CLEARING},
+    pv_lines(1),
+    data{std::make_unique_for_overwrite<ThreadData>()},
     thread(&EngineThread::loop, this)
 {
 
@@ -43,30 +62,54 @@ void EngineThread::loop() {
 
     while (true) {
         std::unique_lock<std::mutex> lock(this->mutex);
-        this->status = EngineThreadStatus::IDLE;
-        this->cv.notify_all(); // notify for any wait_until_stop()
+        this->busy = false;
+        this->cv.notify_all(); // notify for any wait_until_stopped()
 
         this->cv.wait(lock, [this]{
-            return this->status == EngineThreadStatus::RUNNING
-                || this->status == EngineThreadStatus::EXITING;
+            return this->status != EngineThreadStatus::IDLE;
         });
 
         // exit/shutdown thread
-        if (this->status == EngineThreadStatus::EXITING) {
+        const EngineThreadStatus job = this->status;
+        if (job == EngineThreadStatus::EXITING) {
             break;
         }
 
+        this->busy = true;
         lock.unlock();
-        search(*this);
 
-        // reset counter after search
-        this->node_counter = 0;
+        if (job == EngineThreadStatus::RUNNING) {
+            search(*this);
+
+            this->publish_node_counter();
+        }
+        else if (job == EngineThreadStatus::CLEARING) {
+            this->data->reset();
+        }
+
+        // job finished (unless already stopped/exiting)
+        lock.lock();
+        if (this->status == job) {
+            this->status = EngineThreadStatus::IDLE;
+        }
     }
 }
 
 void EngineThread::start_search() {
 
     std::unique_lock<std::mutex> lock(this->mutex);
+
+    // no results until the thread searched (a search can be stopped before it started)
+    this->pv_lines.assign(1, PVLine{});
+    this->completed_depth = 0;
+
+    // reset counters before the thread wakes up (kept afterwards for reporting),
+    // otherwise the node sum still has the previous search's count until the thread resets it
+    this->node_counter              = 0;
+    this->cutoff_counter            = 0;
+    this->first_move_cutoff_counter = 0;
+    this->publish_node_counter();
+
     this->status = EngineThreadStatus::RUNNING;
     lock.unlock();
     this->cv.notify_all();
@@ -74,7 +117,9 @@ void EngineThread::start_search() {
 
 void EngineThread::stop_search() {
     std::unique_lock<std::mutex> lock(this->mutex);
-    this->status = EngineThreadStatus::IDLE;
+    if (this->status == EngineThreadStatus::RUNNING) {
+        this->status = EngineThreadStatus::IDLE;
+    }
     lock.unlock();
     this->cv.notify_all();
 }
@@ -82,24 +127,23 @@ void EngineThread::stop_search() {
 void EngineThread::wait_until_stopped() {
     std::unique_lock<std::mutex> lock(this->mutex);
     this->cv.wait(lock, [this]{
-        return this->status == EngineThreadStatus::IDLE;
+        return this->status == EngineThreadStatus::IDLE
+            && !this->busy;
     });
 }
 
 bool EngineThread::check_stop() const {
 
-    std::size_t total_node_counter       = Engine::thread_pool.sum_threads(&EngineThread::node_counter); // this is total since engine started current search
-    Engine::search_info.depth_node_count = total_node_counter;                                           // this gets reset to 0 at the start of each iterative deepening iteration
-
     if (!Engine::search_info.infinite) {
-        
-        const Milliseconds time_spent = current_time() - Engine::search_info.start_time;
-        
+
+        const uint64_t     total_node_counter = Engine::thread_pool.sum_threads(&EngineThread::get_node_counter);
+        const Milliseconds time_spent         = current_time() - Engine::search_info.start_time;
+
         const bool hit_max_nodes = total_node_counter >= Engine::search_info.max_nodes;
         const bool hit_max_time  = time_spent         >= Engine::search_info.max_time;
 
         if (hit_max_nodes || hit_max_time) {
-            Engine::thread_pool.stop_search();
+            Engine::thread_pool.signal_stop();
             return true;
         }
     }
@@ -108,6 +152,44 @@ bool EngineThread::check_stop() const {
 }
 
 
+// thread data
+
+void EngineThread::start_clear() {
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->status = EngineThreadStatus::CLEARING;
+    lock.unlock();
+    this->cv.notify_all();
+}
+
+
+// search results
+
+const PVLine& EngineThread::get_pv_line() const {
+    return this->pv_lines.front();
+}
+
+Depth EngineThread::get_completed_depth() const {
+    return this->completed_depth;
+}
+
+
+// search stats
+
+// published count (exact once the search finished)
+uint64_t EngineThread::get_node_counter() const {
+    return this->published_node_counter.load(std::memory_order_relaxed);
+}
+
+uint64_t EngineThread::get_cutoff_counter() const {
+    return this->cutoff_counter;
+}
+
+uint64_t EngineThread::get_first_move_cutoff_counter() const {
+    return this->first_move_cutoff_counter;
+}
+
+
 // utils
 
 bool EngineThread::is_main_thread() const {
@@ -125,55 +207,154 @@ EngineThreadPool::EngineThreadPool(std::size_t num_threads) :
     for (std::size_t thread_id = 0; thread_id < this->num_threads; ++thread_id) {
         this->thread_pool.emplace_back(std::make_unique<EngineThread>(thread_id));
     }
+
+    // wait for initial clear of thread data
+    this->wait_until_stopped();
 }
 
 
-// status
+// number of threads
 
-bool EngineThreadPool::is_running() const {
-    return this->status == EnginePoolStatus::RUNNING;
+std::size_t EngineThreadPool::get_num_threads() const {
+    return this->num_threads;
 }
 
-void EngineThreadPool::start_search(SearchInfo&& search_info) {
+// threads are recreated (with cleared thread data)
+void EngineThreadPool::set_num_threads(std::size_t num_threads) {
 
-    // stop any current search
-    if (this->is_running()) {
-        this->stop_search();
+    this->stop_search();
+
+    this->num_threads = std::max<std::size_t>(num_threads, 1);
+
+    this->thread_pool.clear();
+    for (std::size_t thread_id = 0; thread_id < this->num_threads; ++thread_id) {
+        this->thread_pool.emplace_back(std::make_unique<EngineThread>(thread_id));
     }
 
+    this->wait_until_stopped();
+}
+
+
+// status
+
+void EngineThreadPool::start_search(SearchInfo&& search_info) {
+
+    // stop any current search (and wait for threads still finishing a stopped search)
+    this->stop_search();
+
     Engine::search_info = std::move(search_info);
 
+    this->status = EnginePoolStatus::RUNNING;
+
     for (auto pp_thread   = this->thread_pool.rbegin();
               pp_thread  != this->thread_pool.rend();
             ++pp_thread) 
     {
         (*pp_thread)->start_search();
     }
-
-    this->status = EnginePoolStatus::RUNNING;
 }
 
 void EngineThreadPool::stop_search() {
-    
+    this->signal_stop();
+    this->wait_until_stopped();
+}
+
+void EngineThreadPool::signal_stop() {
+
+    this->status = EnginePoolStatus::IDLE;
+
     for (auto pp_thread   = this->thread_pool.rbegin();
               pp_thread  != this->thread_pool.rend();
             ++pp_thread)
     {
         (*pp_thread)->stop_search();
+    }
+}
+
+void EngineThreadPool::wait_until_stopped() {
+    for (auto& p_thread : this->thread_pool) {
+        p_thread->wait_until_stopped();
+    }
+}
+
+// called by the main thread at the end of its search (it can not wait for itself)
+void EngineThreadPool::wait_for_helpers() {
+    for (auto pp_thread  = std::next(this->thread_pool.begin());
+              pp_thread != this->thread_pool.end();
+            ++pp_thread)
+    {
         (*pp_thread)->wait_until_stopped();
     }
+}
 
-    this->status = EnginePoolStatus::IDLE;
+
+// lazy smp best thread vote
+// every thread votes for its best move, weighted by its completed depth and how much its score
+// is above the lowest score of all threads, the thread of the most voted move wins
+// (ties go to the main thread, so a single thread always reports its own search)
+// https://www.chessprogramming.org/Lazy_SMP
+
+const EngineThread& EngineThreadPool::best_thread() const {
+
+    const EngineThread* p_best_thread = this->thread_pool.front().get();
+
+    auto has_result = [](const EngineThread& engine_thread) {
+        return engine_thread.get_pv_line().get_size() != 0;
+    };
+    if (!has_result(*p_best_thread)) {return *p_best_thread;}
+
+    Eval min_score = Evals::INF;
+    for (const auto& p_thread : this->thread_pool) {
+        if (has_result(*p_thread)) {
+            min_score = std::min(min_score, p_thread->get_pv_line().get_score());
+        }
+    }
+
+    std::vector<std::pair<Move, int64_t>> votes;
+    auto move_votes = [&votes](Move move) -> int64_t& {
+        for (auto& [vote_move, num_votes] : votes) {
+            if (vote_move == move) {return num_votes;}
+        }
+        return votes.emplace_back(move, 0).second;
+    };
+
+    for (const auto& p_thread : this->thread_pool) {
+        if (!has_result(*p_thread)) {continue;}
+
+        const PVLine& pv_line = p_thread->get_pv_line();
+        move_votes(pv_line[0]) += (static_cast<int64_t>(pv_line.get_score()) - min_score + SMP_VOTE_MIN_WEIGHT) * p_thread->get_completed_depth();
+
+        if (move_votes(pv_line[0]) > move_votes(p_best_thread->get_pv_line()[0])) {
+            p_best_thread = p_thread.get();
+        }
+    }
+
+    return *p_best_thread;
+}
+
+
+// thread data
+
+void EngineThreadPool::clear_thread_data() {
+
+    this->stop_search();
+
+    // each thread clears its own data in parallel
+    for (auto& p_thread : this->thread_pool) {
+        p_thread->start_clear();
+    }
+
+    this->wait_until_stopped();
 }
 
 
 // utils
 
-uint64_t EngineThreadPool::sum_threads(std::atomic<uint64_t> EngineThread::* member) const {
+uint64_t EngineThreadPool::sum_threads(uint64_t (EngineThread::* getter)() const) const {
 
     uint64_t sum = 0;
     for (auto& p_thread : this->thread_pool) {
-        sum += (*p_thread.*member).load(std::memory_order_relaxed);
+        sum += (*p_thread.*getter)();
     }
 
     return sum;
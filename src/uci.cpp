@@ -12,9 +12,16 @@
 #include "movegen.hpp"     // movegen
 #include "engine.hpp"      // engine globals (searchinfo)
 #include "timemanager.hpp" // timemanager
+#include "matesearch.hpp"  // mate batch
+#include "perft.hpp"       // perft, perft suite
+#include "bench.hpp"       // bench
 
 #include <string>          // string
 #include <sstream>         // stringstream
+#include <vector>          // vector
+#include <algorithm>       // min, max, clamp, transform
+#include <charconv>        // from_chars
+#include <cctype>          // tolower
 
 using namespace MPChess::Types;
 using namespace MPChess::Constants;
@@ -43,15 +50,34 @@ std::string move_to_uci_notation(Move move) {
 }
 
 Move uci_notation_to_move(std::string_view notation, const Board& board) {
-    if (notation.size() < 2 || notation.size() > 5 || notation == "0000") {
+    if (notation.size() < 4 || notation.size() > 5) {
         return {}; // null move
     }
 
-    RegularMoveList pseudo_legal_moves;
-    generate_moves<MoveGenType::PSEUDOLEGAL>(board, pseudo_legal_moves);
+    // decode squares and promotion piece directly, then match against the legal moves
+    // (no move is formatted to a string)
+    const Square from = notation_to_square(notation.substr(0, 2));
+    const Square to   = notation_to_square(notation.substr(2, 2));
+    if (from == Square::NO_SQUARE || to == Square::NO_SQUARE) {
+        return {}; // null move
+    }
 
-    for (const Move& move : pseudo_legal_moves) {
-        if (move_to_uci_notation(move) == notation) {
+    PieceType promote = PieceType::NO_PIECE_TYPE;
+    if (notation.size() == 5) {
+        const auto promote_index = PIECE_TYPE_LABELS.find(notation[4]);
+        if (promote_index == PIECE_TYPE_LABELS.npos) {
+            return {}; // null move
+        }
+        promote = static_cast<PieceType>(promote_index);
+    }
+
+    RegularMoveList legal_moves;
+    generate_moves<MoveGenType::LEGAL>(board, legal_moves);
+
+    for (const Move& move : legal_moves) {
+        if (move.get_from_square() == from && move.get_to_square() == to
+            && (move.is_promote() ? move.get_promote_piece_type() : PieceType::NO_PIECE_TYPE) == promote)
+        {
             return move;
         }
     }
@@ -68,120 +94,284 @@ void print_welcome() {
 
 void uci_loop() {
 
-    std::string line, chunk;
+    std::string line;
     while(std::getline(std::cin, line)) {
+        if (!parse_command(line)) {break;}
+    }
+}
 
-        std::istringstream stream(line);
-        chunk.clear();
-        stream >> chunk;
+// returns false on quit
+bool parse_command(const std::string& line) {
 
-        if (chunk == "uci") {
-            std::cout << "id name MPChess\n"
-                     << "id author Matthew Pham\n"
-                     << "uciok\n\n";
-        }
+    std::istringstream stream(line);
+    std::string chunk;
+    stream >> chunk;
 
-        else if (chunk == "isready") {
-            std::cout << "readyok\n\n";
-        }
+    if (chunk == "uci") {
+        std::cout << "id name MPChess\n"
+                 << "id author Matthew Pham\n"
+                 << "option name Threads type spin default 1 min 1 max 1024\n"
+                 << "option name Hash type spin default " << DEFAULT_TABLE_SIZE_MB << " min 1 max 65536\n"
+                 << "option name MultiPV type spin default 1 min 1 max 256\n"
+                 << "option name ABDADA type check default false\n"
+                 << "uciok\n\n";
+    }
 
-        else if (chunk == "setoption") {
-            // TODO
-        }
+    else if (chunk == "isready") {
+        std::cout << "readyok\n\n";
+    }
 
-        else if (chunk == "debug") {
-            stream >> chunk;
-            if (chunk == "y"   ||
-                chunk == "yes" ||
-                chunk == "on")
-            {
-                Engine::options.debug = true;
-            }
-            else {
-                Engine::options.debug = false;
-            }
-        }
+    else if (chunk == "setoption") {
+        Engine::thread_pool.stop_search();
+        parse_setoption(stream);
+    }
 
-        else if (chunk == "position") {
-            parse_position(stream);
+    else if (chunk == "debug") {
+        stream >> chunk;
+        if (chunk == "y"   ||
+            chunk == "yes" ||
+            chunk == "on")
+        {
+            Engine::options.debug = true;
         }
-
-        else if (chunk == "go") {
-            parse_go(stream);
+        else {
+            Engine::options.debug = false;
         }
+    }
 
-        else if (chunk == "stop") {
-            Engine::thread_pool.stop_search();
-        }
+    else if (chunk == "position") {
+        parse_position(stream);
+    }
 
-        else if (chunk == "ucinewgame") {
-            Engine::thread_pool.stop_search();
-            
-            // clear tt, history heuristic, and killer moves
-            Engine::tt.reset();
-            Engine::history_table = {0};
-            Engine::killer_table  = {Move{}};
-        }
+    else if (chunk == "go") {
+        parse_go(stream);
+    }
 
-        else if (chunk == "isready") {
-            std::cout << "readyok\n";
-            
-        }
+    else if (chunk == "stop") {
+        Engine::thread_pool.stop_search();
+    }
 
-        else if (chunk == "print" ||
-                 chunk == "d")
-        {
-            std::cout << Engine::engine_board << "\n\n";
-        }
+    else if (chunk == "ucinewgame") {
+        Engine::thread_pool.stop_search();
+        
+        // clear tt, abdada table and per-thread data (history heuristics, killer moves, search stack)
+        Engine::tt.reset();
+        Engine::abdada_table.reset();
+        Engine::mate_solver.get_table().reset();
+        Engine::thread_pool.clear_thread_data();
+    }
 
-        else if (chunk == "quit" ||
-                 chunk == "exit")
-        {
-            std::cout << "Quitting. Good Bye.\n\n";
+    else if (chunk == "matebatch") {
+        Engine::thread_pool.stop_search();
+        parse_mate_batch(stream);
+    }
 
-            Engine::thread_pool.stop_search();
+    else if (chunk == "bench") {
+        parse_bench(stream);
+    }
 
-            break;
-        }
+    else if (chunk == "perftsuite") {
+        Engine::thread_pool.stop_search();
+        parse_perft_suite(stream);
     }
+
+    else if (chunk == "isready") {
+        std::cout << "readyok\n";
+        
+    }
+
+    else if (chunk == "print" ||
+             chunk == "d")
+    {
+        std::cout << Engine::engine_board << "\n\n";
+    }
+
+    else if (chunk == "quit" ||
+             chunk == "exit")
+    {
+        std::cout << "Quitting. Good Bye.\n\n";
+
+        Engine::thread_pool.stop_search();
+
+        return false;
+    }
+
+    return true;
 }
 
 void parse_position(std::istringstream& stream) {
 
-    Board parse_board;
+    std::string fen;
     std::string chunk;
     stream >> chunk;
 
     // parse fen
     if (chunk == "startpos") {
-        parse_board.set_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+        fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
         stream >> chunk;
     }
     else if (chunk == "fen") {
-        std::string fen;
         while (stream >> chunk && chunk != "moves") {
             fen += chunk + " ";
         }
         fen.pop_back();
-
-        parse_board.set_fen(std::move(fen));
     }
     else {
         return;
     }
 
     // parse moves
+    std::vector<std::string> moves;
     if (chunk == "moves") {
-        Move move;
         while (stream >> chunk) {
-            move = uci_notation_to_move(chunk, parse_board);
-            if (move.is_null()) {break;}
-            parse_board.make_move(move);
+            moves.push_back(chunk);
+        }
+    }
+
+    // the engine board is played from the fen (keeping the game history, for repetitions)
+    // if the fen is the same as the previous command, moves both commands share are kept
+    // and only the rest are unmade/made (a game only adds a move or two per command)
+    Board&                   board    = Engine::engine_board;
+    Engine::PositionCommand& position = Engine::position_command;
+
+    std::size_t num_shared = 0;
+    if (fen == position.fen && board.get_ply_played() == position.moves.size()) {
+        while (num_shared < std::min(moves.size(), position.moves.size()) && moves[num_shared] == position.moves[num_shared]) {
+            ++num_shared;
         }
+        for (std::size_t index = num_shared; index < position.moves.size(); ++index) {
+            board.unmake_move();
+        }
+    }
+    else {
+        board.set_fen(std::string(fen));
+    }
+
+    position.fen = std::move(fen);
+    position.moves.resize(num_shared);
+
+    for (std::size_t index = num_shared; index < moves.size(); ++index) {
+        const Move move = uci_notation_to_move(moves[index], board);
+        if (move.is_null()) {break;}
+
+        board.make_move(move);
+        position.moves.push_back(std::move(moves[index]));
+    }
+}
+
+// spin option value, false (value ignored) if it is missing or not a number
+static bool parse_spin_value(const std::string& value, std::size_t min, std::size_t max, std::size_t& result) {
+    std::size_t parsed = 0;
+    const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+    if (value.empty() || error != std::errc{} || end != value.data() + value.size()) {
+        std::cout << "info string invalid value \"" << value << "\"\n";
+        return false;
+    }
+    result = std::clamp(parsed, min, max);
+    return true;
+}
+
+// setoption name <id> [value <x>]
+// option names and check values are case insensitive
+void parse_setoption(std::istringstream& stream) {
+
+    std::string chunk;
+    stream >> chunk;
+    if (chunk != "name") {return;}
+
+    // names can have spaces
+    std::string name;
+    while (stream >> chunk && chunk != "value") {
+        name += chunk + " ";
+    }
+    if (name.empty()) {return;}
+    name.pop_back();
+
+    std::string value;
+    stream >> value;
+
+    const auto to_lower = [](std::string text) {
+        std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) {return std::tolower(c);});
+        return text;
+    };
+    name  = to_lower(name);
+    value = to_lower(value);
+
+    if (name == "threads") {
+        if (parse_spin_value(value, 1, 1024, Engine::options.num_threads)) {
+            Engine::thread_pool.set_num_threads(Engine::options.num_threads);
+        }
+    }
+    else if (name == "hash") {
+        if (parse_spin_value(value, 1, 65536, Engine::options.hash_size_mb)) {
+            Engine::tt.resize(Engine::options.hash_size_mb);
+        }
+    }
+    else if (name == "multipv") {
+        parse_spin_value(value, 1, 256, Engine::options.num_pvs);
+    }
+    else if (name == "abdada") {
+        Engine::options.abdada = (value == "true");
+        Engine::abdada_table.reset();
+    }
+    else {
+        std::cout << "info string unknown option " << name << "\n";
     }
+}
+
+// matebatch <epd file> [threads] [hash mb]
+void parse_mate_batch(std::istringstream& stream) {
+
+    std::string epd_path;
+    std::size_t num_threads   = Engine::options.num_threads;
+    std::size_t table_size_mb = DEFAULT_MATE_TABLE_SIZE_MB;
+
+    if (!(stream >> epd_path)) {
+        std::cout << "info string usage: matebatch <epd file> [threads] [hash]\n";
+        return;
+    }
+
+    std::string chunk;
+    if (stream >> chunk) {num_threads   = std::stoul(chunk);}
+    if (stream >> chunk) {table_size_mb = std::stoul(chunk);}
+
+    mate_batch(epd_path, num_threads, table_size_mb);
+}
+
+// bench [depth] [threads] [hash mb]
+void parse_bench(std::istringstream& stream) {
+
+    Depth       depth        = DEFAULT_BENCH_DEPTH;
+    std::size_t num_threads  = 1;
+    std::size_t hash_size_mb = Engine::options.hash_size_mb;
+
+    std::string chunk;
+    if (stream >> chunk) {depth        = std::stoul(chunk);}
+    if (stream >> chunk) {num_threads  = std::stoul(chunk);}
+    if (stream >> chunk) {hash_size_mb = std::stoul(chunk);}
 
-    std::string parsed_fen = parse_board.get_fen();
-    Engine::engine_board.set_fen(std::move(parsed_fen));
+    bench(depth, num_threads, hash_size_mb);
+}
+
+// perftsuite <epd file> [threads] [hash mb] [max depth]
+void parse_perft_suite(std::istringstream& stream) {
+
+    std::string  epd_path;
+    std::size_t  num_threads   = Engine::options.num_threads;
+    std::size_t  table_size_mb = DEFAULT_PERFT_TABLE_SIZE_MB;
+    unsigned int max_depth     = DEFAULT_PERFT_SUITE_DEPTH;
+
+    if (!(stream >> epd_path)) {
+        std::cout << "info string usage: perftsuite <epd file> [threads] [hash] [max depth]\n";
+        return;
+    }
+
+    std::string chunk;
+    if (stream >> chunk) {num_threads   = std::stoul(chunk);}
+    if (stream >> chunk) {table_size_mb = std::stoul(chunk);}
+    if (stream >> chunk) {max_depth     = std::stoul(chunk);}
+
+    perft_suite(epd_path, num_threads, table_size_mb, max_depth);
 }
 
 void parse_go(std::istringstream& stream) {
@@ -256,10 +446,16 @@ void parse_go(std::istringstream& stream) {
             parse_search_info.max_nodes = std::stoul(chunk);
         }
 
+        // perft, counts leaf nodes instead of searching
+        else if (chunk == "perft") {
+            stream >> chunk;
+            std::cout << parallel_perft(Engine::engine_board, std::stoul(chunk), Engine::options.num_threads) << std::endl;
+            return;
+        }
+
         // search for mate in n
         else if (chunk == "mate") {
             stream >> chunk;
-            // TODO
             parse_search_info.mate_in_n = std::stoul(chunk);
         }
         
@@ -7,6 +7,12 @@
 
 #include "perft.hpp"
 #include "board.hpp"
+#include "movegen.hpp"
+#include "uci.hpp"
+#include "engine.hpp"
+#include "matesearch.hpp"
+
+#include <set>
 
 using namespace MPChess;
 using namespace MPChess::Types;
@@ -95,3 +101,248 @@ TEST_CASE("FEN #6 \"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK
 
     REQUIRE(node_count == 164075551ull);
 }
+
+
+
+// specialised generators must match the filtered pseudolegal moves on every node of a small tree
+static std::set<MoveData> move_set(const RegularMoveList& move_list) {
+    std::set<MoveData> moves;
+    for (const Move& move : move_list) {moves.insert(move.get_data());}
+    return moves;
+}
+
+static void check_specialised_generators(Board& board, uint depth) {
+
+    RegularMoveList legal_moves, pseudo_legal_moves, quiet_checks;
+    generate_moves<MoveGenType::LEGAL>(board, legal_moves);
+    generate_moves<MoveGenType::PSEUDOLEGAL>(board, pseudo_legal_moves);
+    generate_moves<MoveGenType::QUIET_CHECKS>(board, quiet_checks);
+
+    // quiet checks == non-capture, non-promote, non-castle moves that give check
+    RegularMoveList expected_quiet_checks;
+    for (const Move& move : pseudo_legal_moves) {
+        if (move.is_capture() || move.is_promote() || move.is_castle()) {continue;}
+
+        board.make_move(move);
+        if (board.is_check<true>()) {expected_quiet_checks.add_move(move);}
+        board.unmake_move();
+    }
+    REQUIRE(quiet_checks.get_size() == expected_quiet_checks.get_size());
+    REQUIRE(move_set(quiet_checks)  == move_set(expected_quiet_checks));
+
+    // evasions == legal moves in check
+    if (board.is_check<true>()) {
+        RegularMoveList evasions;
+        generate_moves<MoveGenType::EVASIONS>(board, evasions);
+        REQUIRE(move_set(evasions) == move_set(legal_moves));
+    }
+
+    if (depth == 0) {return;}
+
+    for (const Move& move : legal_moves) {
+        board.make_move(move);
+        check_specialised_generators(board, depth - 1);
+        board.unmake_move();
+    }
+}
+
+TEST_CASE("EVASIONS and QUIET_CHECKS generation @ Depth=2", "[movegen]")
+{
+    for (const char* fen : {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -",
+                            "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+                            "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                            "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"})
+    {
+        Board board{std::string(fen)};
+        check_specialised_generators(board, 2);
+    }
+}
+
+// gives_check must match is_check after make move for every legal move of a perft tree
+static uint64_t check_gives_check(Board& board, uint depth) {
+
+    RegularMoveList legal_moves;
+    generate_moves<MoveGenType::LEGAL>(board, legal_moves);
+
+    const CheckInfo check_info = board.get_check_info();
+
+    uint64_t checks = 0;
+    for (const Move& move : legal_moves) {
+        const bool gives_check = board.gives_check(move, check_info);
+
+        board.make_move(move);
+        REQUIRE(gives_check == board.is_check<true>());
+        checks += gives_check;
+
+        if (depth > 1) {checks += check_gives_check(board, depth - 1);}
+        board.unmake_move();
+    }
+
+    return checks;
+}
+
+TEST_CASE("gives_check @ Depth=3", "[movegen]")
+{
+    uint64_t checks = 0;
+    for (const char* fen : {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -",
+                            "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+                            "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                            "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+                            "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10"})
+    {
+        Board board{std::string(fen)};
+        checks += check_gives_check(board, 3);
+    }
+
+    CHECK(checks > 0);
+}
+
+// incrementally updated zobrist key must match the key generated from scratch (via fen)
+static void check_zobrist_keys(Board& board, uint depth) {
+
+    REQUIRE(board.get_zobrist_key() == Board{board.get_fen()}.get_zobrist_key());
+    if (depth == 0) {return;}
+
+    RegularMoveList legal_moves;
+    generate_moves<MoveGenType::LEGAL>(board, legal_moves);
+
+    for (const Move& move : legal_moves) {
+        board.make_move(move);
+        check_zobrist_keys(board, depth - 1);
+        board.unmake_move();
+    }
+}
+
+TEST_CASE("incremental zobrist keys @ Depth=3", "[zobrist]")
+{
+    for (const char* fen : {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -",
+                            "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+                            "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1"})
+    {
+        Board board{std::string(fen)};
+        check_zobrist_keys(board, 3);
+    }
+}
+
+TEST_CASE("Hashed parallel perft", "[perft]")
+{
+    // small table, so entries are replaced while threads read them
+    const std::size_t num_threads   = 2;
+    const std::size_t table_size_mb = 1;
+
+    CHECK(parallel_perft(Board{}, 6, num_threads, table_size_mb).nodes == 119060324ull);
+    CHECK(parallel_perft(Board{"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -"}, 5, num_threads, table_size_mb).nodes == 193690690ull);
+    CHECK(parallel_perft(Board{"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -"}, 7, num_threads, table_size_mb).nodes == 178633661ull);
+    CHECK(parallel_perft(Board{"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1"}, 5, num_threads, table_size_mb).nodes == 15833292ull);
+    CHECK(parallel_perft(Board{"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"}, 5, num_threads, table_size_mb).nodes == 89941194ull);
+    CHECK(parallel_perft(Board{"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10"}, 5, num_threads, table_size_mb).nodes == 164075551ull);
+}
+
+TEST_CASE("Board copy keeps the move history", "[board]")
+{
+    const std::string fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+
+    Board board{std::string(fen)};
+    for (std::size_t ply = 0; ply < 6; ++ply) {
+        RegularMoveList move_list;
+        generate_moves<MoveGenType::LEGAL>(board, move_list);
+        board.make_move(move_list[ply % move_list.get_size()]);
+    }
+
+    Board copy{board};
+    CHECK(copy.get_fen()         == board.get_fen());
+    CHECK(copy.get_zobrist_key() == board.get_zobrist_key());
+    CHECK(copy.get_ply_played()  == board.get_ply_played());
+
+    // the copy unmakes back to the root, the original is untouched
+    const std::string board_fen = board.get_fen();
+    while (copy.get_ply_played() > 0) {
+        copy.unmake_move();
+    }
+    CHECK(copy.get_fen()  == fen);
+    CHECK(board.get_fen() == board_fen);
+
+    copy.clone_into(board);
+    CHECK(board.get_fen()        == fen);
+    CHECK(board.get_ply_played() == 0);
+}
+
+TEST_CASE("Repetition and upcoming repetition", "[board]")
+{
+    auto play = [](Board& board, std::initializer_list<std::string_view> line) {
+        for (std::string_view notation : line) {
+            board.make_move(UCI::uci_notation_to_move(notation, board));
+        }
+    };
+
+    Board board{std::string("4k3/8/8/8/8/8/4P3/R3K3 w - - 0 1")};
+
+    // pawn moves are irreversible
+    play(board, {"e2e3"});
+    CHECK(board.get_ply_clock() == 0);
+
+    // white can return to the position 3 plies ago (only a draw if that is within the search)
+    play(board, {"e8d8", "a1a2", "d8e8"});
+    CHECK(!board.is_repetition());
+    CHECK( board.has_upcoming_repetition(4));
+    CHECK(!board.has_upcoming_repetition(3));
+
+    // same position and side to move as 4 plies ago
+    play(board, {"a2a1"});
+    CHECK(board.is_repetition());
+
+    // the black king walks a cycle, so only the position 7 plies ago is one white move away
+    // (the rook returning from a3 to a1, if a2 is empty)
+    const std::initializer_list<std::string_view> line = {"e8d8", "a1b1", "d8d7", "b1b3", "d7e7", "b3a3", "e7e8"};
+
+    Board open{std::string("4k3/8/8/8/8/8/8/R3K3 b - - 0 1")};
+    play(open, line);
+    CHECK(open.has_upcoming_repetition(8));
+
+    Board blocked{std::string("4k3/8/8/8/8/8/P7/R3K3 b - - 0 1")};
+    play(blocked, line);
+    CHECK(!blocked.has_upcoming_repetition(8));
+}
+
+TEST_CASE("Position command keeps the game history", "[uci]")
+{
+    const Board& board = Engine::engine_board;
+
+    UCI::parse_command("position startpos moves g1f3 g8f6 f3g1");
+    CHECK(board.get_ply_played() == 3);
+    CHECK(!board.is_repetition());
+
+    // only the added move is played, the history still has the start position
+    UCI::parse_command("position startpos moves g1f3 g8f6 f3g1 f6g8");
+    CHECK(board.get_ply_played() == 4);
+    CHECK(board.is_repetition());
+
+    // a different line is unmade back to the shared moves
+    UCI::parse_command("position startpos moves g1f3 b8c6");
+    CHECK(board.get_ply_played() == 2);
+    CHECK(board.get_fen() == "r1bqkbnr/pppppppp/2n5/8/8/5N2/PPPPPPPP/RNBQKB1R w KQkq - 2 2");
+
+    UCI::parse_command("position fen 8/8/8/8/8/8/8/K1k5 w - - 0 1");
+    CHECK(board.get_ply_played() == 0);
+}
+
+TEST_CASE("Mate solver", "[mate]")
+{
+    MateSolver solver(1);
+
+    // 1. Ra6 bxa6 2. b7#
+    Board mate_in_2{std::string("kbK5/pp6/1P6/8/8/8/8/R7 w - - 0 1")};
+    const MateResult result = solver.solve(mate_in_2, 3);
+    CHECK(result.proven);
+    CHECK(result.mate_in_n == 2);
+    REQUIRE(result.pv.get_size() != 0);
+    CHECK(UCI::move_to_uci_notation(result.pv[0]) == "a1a6");
+    CHECK(mate_in_2.get_fen() == "kbK5/pp6/1P6/8/8/8/8/R7 w - - 0 1");
+
+    Board no_mate{std::string("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1")};
+    const MateResult no_result = solver.solve(no_mate, 3);
+    CHECK(!no_result.proven);
+    CHECK(!no_result.stopped);
+}
\ No newline at end of file
@@ -0,0 +1,264 @@
+// magic_generator.cpp
+// offline magic number search, prints include/magics.hpp
+// the engine only uses the printed magics, so this only needs to run if the search changes
+//
+// usage: magic_generator [optimize iterations] > include/magics.hpp
+// without arguments the first valid magic of each square is used (fast),
+// with iterations the search keeps looking for magics with smaller hash tables
+
+#include "defs.hpp"    // types, constants
+#include "utils.hpp"   // pop_count, square_to_notation
+#include "attacks.hpp" // relevant_blocker_mask, slider_attacks
+#include "rng.hpp"     // xorshift64
+
+#include <array>       // array
+#include <vector>      // vector
+#include <string_view> // string_view
+#include <charconv>    // from_chars
+#include <iostream>    // cout, cerr
+#include <iomanip>     // setw, setfill, hex
+
+using namespace MPChess;
+using namespace MPChess::Attacks;
+
+
+struct FoundMagic {
+    uint64_t    magic;
+    std::size_t key_shift;
+};
+
+// find magics
+template<Types::PieceType slider, bool optimize=false>
+requires (slider == Types::PieceType::BISHOP) || (slider == Types::PieceType::ROOK)
+FoundMagic find_magic(Types::Square sq, 
+                      std::size_t iterations=100000000,
+                      Rng::XorShift64& rng=Rng::main_rng) {
+
+    // get relevant blocker squares and shift used for hashing
+    const Types::Bitboard relevant_blockers = relevant_blocker_mask<slider>(sq);
+    const std::size_t     bit_count         = pop_count(relevant_blockers);
+    std::size_t           key_shift         = 64 - bit_count;
+
+    // find magics using brute force
+    //
+    // try a magic by generating a random, sparse (not many 1 bits) 64-bit number
+    // a magic is valid if it correctly maps the attacks of all possible blocker
+    // configurations for the sliding piece on a given square
+    // the relevant blocker squares are all the squares a blocker can be on
+    // to validate a magic is valid, need to generate every blocker combination/subset
+    // and use the magic number to hash the subset
+    // if the magic number can hash each subset without any destructive collisions
+    // then the magic is valid
+    //
+    // a destructive collision is when a magic hashes multiple blocker
+    // combinations to the same hash key when the block combinations have
+    // different attack sets
+    // 
+    // a constructive collision is okay i.e. when the magic hashes multiple different
+    // blocker combinations to the same hash key, but the blocker combinations
+    // have the same attack set (e.g. a bishop on a1 will have the same attack
+    // set if there are blockers on [e4, f4, g6] or [e4, g6] or [e4, h8] or ...)
+    //
+    // the hashing function is (magic_bitboard * blockers_bitboard) >> (64 - N)
+    // where N is the number of bits used for a hash key
+    // it is easy to find magic numbers for N = number of blockers in the relevant blocker mask
+    // it is possible to find some magics for some squares where N < number of blockers in relevant mask
+    // but computationally it is much harder
+    // a smaller N just means a smaller final lookup table
+
+    // first generate all possible blocker subsets and corresponding attack sets
+    // will generate subsets using "Carry-Ripple" iteration
+
+    std::vector<Types::Bitboard> blocker_subsets;
+    blocker_subsets.reserve(1 << bit_count);
+
+    std::vector<Types::Bitboard> attack_subsets;
+    attack_subsets.reserve(1 << bit_count);
+
+    // carry-ripple iteration
+    Types::Bitboard blocker_subset{Constants::EMPTY};
+    do {
+        blocker_subset = (blocker_subset - relevant_blockers) & relevant_blockers;
+        const Types::Bitboard attacks = slider_attacks<slider>(sq, blocker_subset);
+
+        blocker_subsets.push_back(blocker_subset);
+        attack_subsets.push_back(attacks);
+
+    } while(blocker_subset);
+
+    // hash function
+    auto hasher = [](uint64_t magic, Types::Bitboard blockers, std::size_t key_shift) -> int {
+        return (magic * blockers) >> key_shift;
+    };
+
+    // find magics
+    Types::Bitboard    best_magic{Constants::EMPTY};
+    std::size_t best_hash_size = (1 << bit_count) + 1;
+
+    // mapped attacks
+    // initialize to empty (no piece/square/blocker combo has an empty attack set)
+    std::vector<Types::Bitboard> mapped_attacks(1 << bit_count, Constants::EMPTY);
+
+    bool repeat_magic = false; // used to repeat best_magic with larger key_shift
+    std::size_t iter=0;
+    while (iter++ <= iterations) {
+
+        // generate candidate magic
+        Types::Bitboard magic = (!repeat_magic) ? rng.generate<Rng::RngType::SPARSE>() : best_magic;
+
+        bool invalid_magic = false;
+        std::size_t hash_size = 0;
+
+        // reset mapped attacks
+        std::fill(mapped_attacks.begin(), mapped_attacks.end(), Constants::EMPTY);
+
+        // loop over all blocker subsets and hash
+        // make sure no destructive collisions
+        for (std::size_t i=0; i<blocker_subsets.size(); ++i) {
+
+            const int hash_key = hasher(magic, blocker_subsets[i], key_shift);
+
+            // unmapped attacks
+            if (mapped_attacks[hash_key] == Constants::EMPTY) {
+
+                mapped_attacks[hash_key] = attack_subsets[i];
+                ++hash_size;
+
+                // if current hash size is larger then the best hash size so far,
+                // restart to try and find magic with more collisions
+                if (hash_size > best_hash_size) {
+                    invalid_magic = true;
+                    break;
+                }
+            }
+            // constructive collision
+            else if (mapped_attacks[hash_key] == attack_subsets[i]) {
+
+            }
+            // destructive collision -- start over with new magic candidate
+            else {
+                invalid_magic = true;
+                break;
+            }
+        }
+
+        // if magic found
+        if (!invalid_magic) {
+
+            if constexpr (optimize) {
+                std::cerr << "\tIter: " << iter << " / " << iterations << "\n";
+                std::cerr << "\tFound magic with hash size: " << hash_size << "\n";
+                std::cerr << "\tMagic: " << magic << "\n";
+                std::cerr << "\tPiece/Types::Square: " << Constants::PIECE_LABELS[slider] << " / " << square_to_notation(sq) << "\n\n";
+            }
+
+            // if better than previous magic
+            if (hash_size < best_hash_size) {
+
+                // update best magic
+                best_magic = magic;
+                best_hash_size = hash_size;
+
+                // if optimization flag not set just return first found valid magic
+                if constexpr (!optimize) {
+                    break;
+                }
+
+                // revalidate magic using larger key_shift
+                // TODO : maybe only do this if hash_size is near half 2^(bit_count)
+                repeat_magic = true;
+                ++key_shift;
+                --iter;
+            }
+        }
+
+        // if failed to revalidate with bigger key shift
+        if (repeat_magic) {
+            repeat_magic = false;
+            
+            // change key_shift back to last valid size
+            if (invalid_magic) {
+                --key_shift;
+            }
+        }
+    }
+
+    return {best_magic, key_shift};
+}
+
+template<Types::PieceType slider>
+std::array<FoundMagic, Constants::NUM_SQUARES> find_magics(std::size_t optimize_iterations) {
+
+    std::array<FoundMagic, Constants::NUM_SQUARES> magics;
+    for (const Types::Square& sq : Constants::ALL_SQUARES) {
+        magics[sq] = (optimize_iterations > 0) ? find_magic<slider, true>(sq, optimize_iterations)
+                                               : find_magic<slider>(sq);
+    }
+
+    return magics;
+}
+
+void print_magics(const char* name, const std::array<FoundMagic, Constants::NUM_SQUARES>& magics) {
+
+    std::cout << "inline constexpr MagicNumbers " << name << " = {{\n";
+    for (const Types::Square& sq : Constants::ALL_SQUARES) {
+        std::cout << "    {0x" << std::hex << std::setw(16) << std::setfill('0') << magics[sq].magic
+                  << "ull, " << std::dec << std::setw(2) << std::setfill(' ') << magics[sq].key_shift << "}, "
+                  << "// " << square_to_notation(sq) << "\n";
+    }
+    std::cout << "}};\n";
+}
+
+auto main(int argc, char* argv[]) -> int {
+
+    // usage goes to cerr, cout is redirected into magics.hpp
+    std::size_t optimize_iterations = 0;
+    if (argc > 1) {
+        const std::string_view arg(argv[1]);
+        const auto [end, error] = std::from_chars(arg.data(), arg.data() + arg.size(), optimize_iterations);
+        if (argc > 2 || error != std::errc{} || end != arg.data() + arg.size()) {
+            std::cerr << "usage: magic_generator [optimize iterations] > include/magics.hpp\n";
+            return 1;
+        }
+    }
+
+    // same rng stream as before the magics were baked in, so the default output is reproducible
+    const auto bishop_magics = find_magics<Types::PieceType::BISHOP>(optimize_iterations);
+    const auto rook_magics   = find_magics<Types::PieceType::ROOK>(optimize_iterations);
+
+    std::cout << "// magics.hpp\n"
+              << "// generated by tools/magic_generator, do not edit\n"
+              << "// https://www.chessprogramming.org/Magic_Bitboards\n"
+              << "\n"
+              << "#pragma once\n"
+              << "\n"
+              << "#include \"defs.hpp\" // types, constants\n"
+              << "\n"
+              << "#include <array>    // array\n"
+              << "\n"
+              << "\n"
+              << "namespace MPChess {\n"
+              << "\n"
+              << "namespace Attacks {\n"
+              << "\n"
+              << "// magic number and key shift of a slider on one square\n"
+              << "// key = ((occupancy & blockers mask) * magic) >> key_shift\n"
+              << "struct MagicNumber {\n"
+              << "    uint64_t    magic;\n"
+              << "    std::size_t key_shift;\n"
+              << "};\n"
+              << "\n"
+              << "using MagicNumbers = std::array<MagicNumber, Constants::NUM_SQUARES>;\n"
+              << "\n";
+
+    print_magics("BISHOP_MAGIC_NUMBERS", bishop_magics);
+    std::cout << "\n";
+    print_magics("ROOK_MAGIC_NUMBERS", rook_magics);
+
+    std::cout << "\n"
+              << "} // Attacks namespace\n"
+              << "\n"
+              << "} // MPChess namespace";
+
+    return 0;
+}
\ No newline at end of file
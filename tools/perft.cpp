@@ -0,0 +1,44 @@
+// perft.cpp
+// multi-threaded hashed perft from the command line
+//
+// usage: perft <depth> [threads] [hash mb] [fen]
+// the fen defaults to the start position
+
+#include "defs.hpp"  // types, constants
+#include "board.hpp" // board
+#include "perft.hpp" // parallel perft
+
+#include <string>    // string, stoul
+#include <iostream>  // cout
+
+using namespace MPChess;
+
+
+auto main(int argc, char* argv[]) -> int {
+
+    if (argc < 2) {
+        std::cout << "usage: perft <depth> [threads] [hash mb] [fen]\n";
+        return 1;
+    }
+
+    const unsigned int depth         = std::stoul(argv[1]);
+    const std::size_t  num_threads   = (argc > 2) ? std::stoul(argv[2]) : 1;
+    const std::size_t  table_size_mb = (argc > 3) ? std::stoul(argv[3]) : Constants::DEFAULT_PERFT_TABLE_SIZE_MB;
+
+    std::string fen;
+    for (int arg_ind = 4; arg_ind < argc; ++arg_ind) {
+        fen += std::string(argv[arg_ind]) + " ";
+    }
+
+    Board board;
+    if (!fen.empty()) {
+        fen.pop_back();
+        board.set_fen(std::move(fen));
+    }
+
+    std::cout << "depth "   << depth       << "\n"
+              << "threads " << num_threads << "\n"
+              << parallel_perft(board, depth, num_threads, table_size_mb);
+
+    return 0;
+}
\ No newline at end of file